@@ -1,5 +1,17 @@
 #include "AABB.h"
 #include <algorithm>
+#include <climits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AABB_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AABB_BATCH_SSE2
+#endif
+
+//Boxes tested per iteration, the arrays are padded to this size
+#define AABB_BATCH_WIDTH 8
 
 AABB::AABB() : pos(Point(0, 0)), width(0), height(0)
 {
@@ -24,4 +36,103 @@ bool AABB::TestCircle(const Point& center, float radius) const
     int distance_x = center.x - closest_x;
     int distance_y = center.y - closest_y;
     return (distance_x * distance_x + distance_y * distance_y) <= (radius * radius);
-}
\ No newline at end of file
+}
+
+AABBBatch::AABBBatch() : count(0)
+{
+}
+void AABBBatch::Clear()
+{
+    minX.clear();
+    maxX.clear();
+    minY.clear();
+    maxY.clear();
+    count = 0;
+}
+void AABBBatch::Add(const AABB& box)
+{
+    if (count == (int)minX.size())
+    {
+        //Padding boxes start after INT_MAX and end before INT_MIN, no box can overlap them
+        minX.resize(count + AABB_BATCH_WIDTH, INT_MAX);
+        maxX.resize(count + AABB_BATCH_WIDTH, INT_MIN);
+        minY.resize(count + AABB_BATCH_WIDTH, INT_MAX);
+        maxY.resize(count + AABB_BATCH_WIDTH, INT_MIN);
+    }
+    minX[count] = box.pos.x;
+    maxX[count] = box.pos.x + box.width;
+    minY[count] = box.pos.y;
+    maxY[count] = box.pos.y + box.height;
+    count++;
+}
+int AABBBatch::GetCount() const
+{
+    return count;
+}
+void AABBBatch::Test(const AABB& box, std::vector<unsigned int>& mask) const
+{
+#if defined(AABB_BATCH_AVX2)
+    mask.assign((count + 31) / 32, 0);
+
+    const __m256i bMinX = _mm256_set1_epi32(box.pos.x);
+    const __m256i bMaxX = _mm256_set1_epi32(box.pos.x + box.width);
+    const __m256i bMinY = _mm256_set1_epi32(box.pos.y);
+    const __m256i bMaxY = _mm256_set1_epi32(box.pos.y + box.height);
+
+    for (int i = 0; i < count; i += 8)
+    {
+        __m256i aMinX = _mm256_loadu_si256((const __m256i*)&minX[i]);
+        __m256i aMaxX = _mm256_loadu_si256((const __m256i*)&maxX[i]);
+        __m256i aMinY = _mm256_loadu_si256((const __m256i*)&minY[i]);
+        __m256i aMaxY = _mm256_loadu_si256((const __m256i*)&maxY[i]);
+
+        //Separated on any axis means no overlap
+        __m256i apart = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(bMinX, aMaxX), _mm256_cmpgt_epi32(aMinX, bMaxX)),
+            _mm256_or_si256(_mm256_cmpgt_epi32(bMinY, aMaxY), _mm256_cmpgt_epi32(aMinY, bMaxY)));
+        unsigned int bits = ~(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(apart)) & 0xFF;
+        mask[i / 32] |= bits << (i % 32);
+    }
+#elif defined(AABB_BATCH_SSE2)
+    mask.assign((count + 31) / 32, 0);
+
+    const __m128i bMinX = _mm_set1_epi32(box.pos.x);
+    const __m128i bMaxX = _mm_set1_epi32(box.pos.x + box.width);
+    const __m128i bMinY = _mm_set1_epi32(box.pos.y);
+    const __m128i bMaxY = _mm_set1_epi32(box.pos.y + box.height);
+
+    for (int i = 0; i < count; i += 4)
+    {
+        __m128i aMinX = _mm_loadu_si128((const __m128i*)&minX[i]);
+        __m128i aMaxX = _mm_loadu_si128((const __m128i*)&maxX[i]);
+        __m128i aMinY = _mm_loadu_si128((const __m128i*)&minY[i]);
+        __m128i aMaxY = _mm_loadu_si128((const __m128i*)&maxY[i]);
+
+        //Separated on any axis means no overlap
+        __m128i apart = _mm_or_si128(
+            _mm_or_si128(_mm_cmpgt_epi32(bMinX, aMaxX), _mm_cmpgt_epi32(aMinX, bMaxX)),
+            _mm_or_si128(_mm_cmpgt_epi32(bMinY, aMaxY), _mm_cmpgt_epi32(aMinY, bMaxY)));
+        unsigned int bits = ~(unsigned int)_mm_movemask_ps(_mm_castsi128_ps(apart)) & 0xF;
+        mask[i / 32] |= bits << (i % 32);
+    }
+#else
+    TestScalar(box, mask);
+    return;
+#endif
+    //Clear the bits of the padding boxes in the last word
+    if (count % 32 != 0) mask[count / 32] &= (1u << (count % 32)) - 1;
+}
+void AABBBatch::TestScalar(const AABB& box, std::vector<unsigned int>& mask) const
+{
+    mask.assign((count + 31) / 32, 0);
+
+    int bMaxX = box.pos.x + box.width;
+    int bMaxY = box.pos.y + box.height;
+    for (int i = 0; i < count; ++i)
+    {
+        if (!(maxX[i] < box.pos.x || bMaxX < minX[i] || maxY[i] < box.pos.y || bMaxY < minY[i]))
+        {
+            mask[i / 32] |= 1u << (i % 32);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include <vector>
 #include "Point.h"
 
 class AABB {
@@ -15,4 +16,26 @@ public:
     bool TestCircle(const Point& center, float radius) const;
 };
 
+//Boxes stored as separate arrays of edges (structure of arrays) so one box can be
+//tested against several of them with a single SIMD instruction.
+//Uses AVX2 when the compiler targets it, SSE2 otherwise and a scalar loop as fallback.
+class AABBBatch {
+public:
+    AABBBatch();
+
+    void Clear();
+    void Add(const AABB& box);
+    int GetCount() const;
+
+    //Bit (i % 32) of mask[i / 32] is set when the box i overlaps 'box'
+    //Same edge rules as AABB::TestAABB
+    void Test(const AABB& box, std::vector<unsigned int>& mask) const;
+    void TestScalar(const AABB& box, std::vector<unsigned int>& mask) const;
+
+private:
+    //Arrays are padded to a multiple of 8 with boxes that never overlap
+    std::vector<int> minX, maxX, minY, maxY;
+    int count;
+};
+
 
@@ -1,131 +1,281 @@
 
 #include "AudioPlayer.h"
+#include "MemTracker.h"
+#include <stdint.h>
+#include <chrono>
 
-AudioPlayer::AudioPlayer() {
+AudioPlayer::AudioPlayer(bool enabled) : enabled(enabled), stream_count(0) {
+	if (!enabled) return;
 
-}
-void AudioPlayer::Update()
-{
-	for (auto& music : musicsData)
-	{
-		if (IsMusicStreamPlaying(music.second)) {
-			UpdateMusicStream(music.second);
-		}
-
-	}
+	running = true;
+	thread = std::thread(&AudioPlayer::ThreadLoop, this);
 }
 
 void AudioPlayer::PlaySoundByName(const char* soundName)
 {
-	if (!IsSoundLoaded(soundName))
+	if (!enabled) return;
+
+	std::shared_lock<std::shared_mutex> guard(maps_lock);
+	Sound* sound = FindSound(soundName);
+	if (sound == nullptr)
 	{
 		printf("Sound File Not Loaded");
 		return;
 	}
-
-	PlaySound(soundsData[soundName]);
+	Post(AudioCommandType::PLAY_SOUND, sound);
 }
 
 void AudioPlayer::PlayMusicByName(const char* musicName)
 {
-	if (!IsMusicLoaded(musicName))
+	if (!enabled) return;
+
+	std::shared_lock<std::shared_mutex> guard(maps_lock);
+	Track* track = FindMusic(musicName);
+	if (track == nullptr)
 	{
 		printf("Sound File Not Loaded");
 		return;
 	}
-	PlayMusicStream(musicsData[musicName]);
+	track->playing = true;
+	Post(AudioCommandType::PLAY_MUSIC, track);
 }
 
 void AudioPlayer::StopMusicByName(const char* musicName)
 {
-	if (!IsMusicLoaded(musicName))
+	if (!enabled) return;
+
+	std::shared_lock<std::shared_mutex> guard(maps_lock);
+	Track* track = FindMusic(musicName);
+	if (track == nullptr)
 	{
 		printf("Music File Not Loaded");
 		return;
 	}
-	StopMusicStream(musicsData[musicName]);
+	track->playing = false;
+	Post(AudioCommandType::STOP_MUSIC, track);
 
 }
 
 void AudioPlayer::DeleteSound(const char* soundName)
 {
-	if (!IsSoundLoaded(soundName))
+	std::unique_lock<std::shared_mutex> guard(maps_lock);
+	Sound* sound = FindSound(soundName);
+	if (sound == nullptr)
 	{
 		printf("Sound File Not Loaded");
 		return;
 	}
-	UnloadSound(soundsData[soundName]);
+	//A play command may still be waiting for the audio thread
+	Flush();
+
+	ResourceBudget::Instance().Remove(ResourceKind::SOUND, (unsigned long long)(uintptr_t)sound);
+	UnloadSound(*sound);
 	soundsData.erase(soundName);
 }
 
 void AudioPlayer::DeleteMusic(const char* musicName)
 {
-	if (!IsMusicLoaded(musicName))
+	std::unique_lock<std::shared_mutex> guard(maps_lock);
+	Track* track = FindMusic(musicName);
+	if (track == nullptr)
 	{
 		printf("Music File Not Loaded");
 		return;
 	}
-	UnloadMusicStream(musicsData[musicName]);
+	//Once the stop has run the audio thread no longer refills the stream
+	if (running) Post(AudioCommandType::STOP_MUSIC, track);
+	Flush();
+
+	Music& music = track->music;
+	ResourceBudget::Instance().Remove(ResourceKind::MUSIC, (unsigned long long)(uintptr_t)&music);
+	UnloadMusicStream(music);
 	musicsData.erase(musicName);
 }
 
 void AudioPlayer::SetMusicLoopStatus(const char* musicName, bool isLoop)
 {
-	if (!IsMusicLoaded(musicName))
+	if (!enabled) return;
+
+	std::shared_lock<std::shared_mutex> guard(maps_lock);
+	Track* track = FindMusic(musicName);
+	if (track == nullptr)
 	{
 		printf("Music File Not Loaded");
 		return;
 	}
-	musicsData[musicName].looping = isLoop;
+	Post(AudioCommandType::SET_LOOP, track, isLoop);
 }
 
 bool AudioPlayer::IsMusicPlaying(const char* musicName)
 {
-	if (!IsMusicLoaded(musicName))
+	if (!enabled) return false;
+
+	std::shared_lock<std::shared_mutex> guard(maps_lock);
+	Track* track = FindMusic(musicName);
+	if (track == nullptr)
 	{
 		printf("Music File Not Loaded");
 		return false;
 	}
-	return IsMusicStreamPlaying(musicsData[musicName]);
+	return track->playing;
 }
 
-void AudioPlayer::CreateSound(const char* path, const char* soundName)
+void AudioPlayer::CreateSound(const char* path, const char* soundName, ResourceOwner owner)
 {
-	if (IsSoundLoaded(soundName))
+	if (!enabled) return;
+
+	std::unique_lock<std::shared_mutex> guard(maps_lock);
+	if (FindSound(soundName) != nullptr)
 	{
 		printf("Sound File Already Loaded");
 		return;
 	}
 
+	MemScope scope(MemTag::AUDIO);
 
-	soundsData[soundName] = LoadSound(path);
+	Sound& sound = soundsData[soundName];
+	sound = LoadSound(path);
+
+	//Sounds keep the whole file decoded in the format of the device
+	//The map keeps its elements in place, their address identifies them in the budget
+	size_t bytes = (size_t)sound.frameCount * sound.stream.channels * (sound.stream.sampleSize / 8);
+	ResourceBudget::Instance().Add(ResourceKind::SOUND, owner, (unsigned long long)(uintptr_t)&sound, path, bytes);
 }
 
-void AudioPlayer::CreateMusic(const char* path, const char* musicName)
+void AudioPlayer::CreateMusic(const char* path, const char* musicName, ResourceOwner owner)
 {
-	if (IsMusicLoaded(musicName))
+	if (!enabled) return;
+
+	std::unique_lock<std::shared_mutex> guard(maps_lock);
+	if (FindMusic(musicName) != nullptr)
 	{
 		printf("Music File Already Loaded");
 		return;
 	}
 
+	MemScope scope(MemTag::AUDIO);
+
+	Music& music = musicsData[musicName].music;
+	music = LoadMusicStream(path);
+
+	//Music is decoded while it plays, only the buffers of its stream stay in memory
+	size_t bytes = (size_t)AUDIO_STREAM_BUFFERS * AUDIO_STREAM_BUFFER_FRAMES(music.stream.sampleRate) *
+		music.stream.channels * (music.stream.sampleSize / 8);
+	ResourceBudget::Instance().Add(ResourceKind::MUSIC, owner, (unsigned long long)(uintptr_t)&music, path, bytes);
+}
+
+
+Sound* AudioPlayer::FindSound(const char* soundName)
+{
+	auto it = soundsData.find(soundName);
+	return it != soundsData.end() ? &it->second : nullptr;
+}
+
+AudioPlayer::Track* AudioPlayer::FindMusic(const char* musicName)
+{
+	auto it = musicsData.find(musicName);
+	return it != musicsData.end() ? &it->second : nullptr;
+}
+
+void AudioPlayer::Post(AudioCommandType type, void* target, bool loop)
+{
+	AudioCommand command = { type, target, loop };
 
-	musicsData[musicName] = LoadMusicStream(path);
+	while (posting.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+	//A full ring is drained by the audio thread within one period
+	while (!commands.Push(command)) std::this_thread::yield();
+	posting.clear(std::memory_order_release);
 }
 
+void AudioPlayer::Flush()
+{
+	if (!running) return;
+
+	size_t pushed = commands.GetPushed();
+	while (executed.load(std::memory_order_acquire) < pushed) std::this_thread::yield();
+}
 
-bool AudioPlayer::IsSoundLoaded(const char* soundName)
+void AudioPlayer::ThreadLoop()
 {
-	return soundsData.find(soundName) != soundsData.end();
+	while (running)
+	{
+		AudioCommand command;
+		bool busy = false;
+		while (commands.Pop(command))
+		{
+			Execute(command);
+			executed.fetch_add(1, std::memory_order_release);
+			busy = true;
+		}
+
+		//Refill the streams, music without loop leaves the list when it ends
+		for (int i = 0; i < stream_count;)
+		{
+			Track* track = streams[i];
+			UpdateMusicStream(track->music);
+			if (!IsMusicStreamPlaying(track->music))
+			{
+				track->playing = false;
+				streams[i] = streams[--stream_count];
+				continue;
+			}
+			++i;
+		}
+
+		//Producers waiting on a full ring are served again at once
+		if (!busy) std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_THREAD_PERIOD_MS));
+	}
 }
 
-bool AudioPlayer::IsMusicLoaded(const char* musicName)
+void AudioPlayer::Execute(const AudioCommand& command)
 {
-	return musicsData.find(musicName) != musicsData.end();
+	if (command.type == AudioCommandType::PLAY_SOUND)
+	{
+		PlaySound(*(Sound*)command.target);
+		return;
+	}
+
+	Track* track = (Track*)command.target;
+	int index = 0;
+	while (index < stream_count && streams[index] != track) ++index;
+
+	switch (command.type)
+	{
+	case AudioCommandType::PLAY_MUSIC:
+		if (index == stream_count)
+		{
+			//Nothing would refill a stream past the list, the music is not started
+			if (stream_count == AUDIO_MAX_STREAMS)
+			{
+				LOG("Audio: %d music streams already playing, music not started", AUDIO_MAX_STREAMS);
+				track->playing = false;
+				break;
+			}
+			streams[stream_count++] = track;
+		}
+		PlayMusicStream(track->music);
+		track->playing = true;
+		break;
+	case AudioCommandType::STOP_MUSIC:
+		StopMusicStream(track->music);
+		if (index < stream_count) streams[index] = streams[--stream_count];
+		break;
+	case AudioCommandType::SET_LOOP:
+		track->music.looping = command.loop;
+		break;
+	default:
+		break;
+	}
 }
 
 AudioPlayer::~AudioPlayer()
 {
+	if (running)
+	{
+		Flush();
+		running = false;
+		thread.join();
+	}
 
 	for (; soundsData.size() != 0;)
 	{
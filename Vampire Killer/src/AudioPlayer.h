@@ -1,38 +1,89 @@
 #pragma once
 #include "Entity.h"
 #include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <shared_mutex>
 #include "raylib.h"
+#include "ResourceBudget.h"
+#include "SpscRing.h"
 
+//Commands waiting for the audio thread, a full ring makes the caller wait
+#define AUDIO_COMMAND_CAPACITY	64
+
+//Time the audio thread sleeps between two passes, the stream buffers last about 33 ms each
+#define AUDIO_THREAD_PERIOD_MS	4
+
+//Music streams playing at the same time
+#define AUDIO_MAX_STREAMS		8
+
+enum class AudioCommandType { PLAY_SOUND, PLAY_MUSIC, STOP_MUSIC, SET_LOOP };
+
+struct AudioCommand
+{
+    AudioCommandType type;
+    void* target;
+    bool loop;
+};
+
+//Sounds and music are loaded and unloaded by the caller, playing them is done by a thread
+//of the player: the calls only post a command, and the same thread refills the streams of
+//the music playing, so a long frame no longer leaves the music without data.
+//Commands can be posted from any thread (gameplay may run on the job system), posting is
+//serialised by a spin lock so the ring always has a single producer. Loading and unloading
+//may also happen while other threads play, the maps are guarded by a shared lock.
 class AudioPlayer : public Entity
 {
 public:
-    static AudioPlayer& Instance()
-    {
-        static AudioPlayer instance; //Guaranteed to be initialized only once
-        return instance;
-    }
-    void Update() override;
+    //A disabled player ignores every call and has no thread, used by worlds without audio device
+    AudioPlayer(bool enabled);
+    ~AudioPlayer();
+
     void PlaySoundByName(const char* soundName);
     void PlayMusicByName(const char* musicName);
     void StopMusicByName(const char* musicName);
-    void CreateSound(const char* path, const char* soundName);
-    void CreateMusic(const char* path, const char* musicName);
+    //The memory of the sound or the music is added to the audio budgets under 'owner'
+    void CreateSound(const char* path, const char* soundName, ResourceOwner owner = ResourceOwner::SCENE);
+    void CreateMusic(const char* path, const char* musicName, ResourceOwner owner = ResourceOwner::SCENE);
     void DeleteSound(const char* soundName);
     void DeleteMusic(const char* musicName);
     void SetMusicLoopStatus(const char* musicName, bool isLoop);
+    //Playing since PlayMusicByName() until it is stopped or, without loop, until it ends
     bool IsMusicPlaying(const char* musicName);
 private:
+    struct Track
+    {
+        Music music;
+        //Written by the caller when it posts a play or a stop and by the audio thread when the music ends
+        std::atomic<bool> playing{ false };
+    };
 
-    //Private constructor to prevent instantiation
-    AudioPlayer();
-    //Destructor
-    ~AudioPlayer();
+    //nullptr when not loaded, the caller holds maps_lock
+    Sound* FindSound(const char* soundName);
+    Track* FindMusic(const char* musicName);
+
+    void Post(AudioCommandType type, void* target, bool loop = false);
+    //Wait until the audio thread has run every command posted, used before unloading
+    void Flush();
+
+    void ThreadLoop();
+    void Execute(const AudioCommand& command);
 
-    bool IsSoundLoaded(const char* soundName);
-    bool IsMusicLoaded(const char* musicName);
     std::unordered_map<const char*, Sound> soundsData;
-    std::unordered_map<const char*, Music> musicsData;
+    std::unordered_map<const char*, Track> musicsData;
+    //Shared to look up a sound or a music, exclusive to add or remove one
+    std::shared_mutex maps_lock;
+    bool enabled;
 
+    SpscRing<AudioCommand, AUDIO_COMMAND_CAPACITY> commands;
+    std::atomic_flag posting = ATOMIC_FLAG_INIT;
+    //Commands already run by the audio thread
+    std::atomic<size_t> executed{ 0 };
 
+    //Only used by the audio thread
+    Track* streams[AUDIO_MAX_STREAMS];
+    int stream_count;
 
-};
\ No newline at end of file
+    std::thread thread;
+    std::atomic<bool> running{ false };
+};
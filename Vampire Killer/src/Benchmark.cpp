@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+#include "SpatialHash.h"
+#include "Globals.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+//Average area in pixels available to each collider, keeps the density constant between cases
+#define BENCHMARK_AREA_PER_ENTITY	(48 * 48)
+
+static std::vector<AABB> RandomBoxes(int count, std::mt19937& rng)
+{
+	int side = (int)std::sqrt((double)count * BENCHMARK_AREA_PER_ENTITY);
+	std::uniform_int_distribution<int> coord(0, side);
+	std::uniform_int_distribution<int> size(8, 32);
+
+	std::vector<AABB> boxes;
+	boxes.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		boxes.push_back(AABB(Point(coord(rng), coord(rng)), size(rng), size(rng)));
+	}
+	return boxes;
+}
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+void RunBroadphaseBenchmark()
+{
+	const int counts[] = { 100, 1000, 10000 };
+
+	//Fixed seed so every run measures the same scenes
+	std::mt19937 rng(1234);
+	SpatialHash hash;
+	std::vector<std::pair<int, int>> pairs;
+
+	for (int count : counts)
+	{
+		std::vector<AABB> boxes = RandomBoxes(count, rng);
+		int i, j, k;
+
+		//Brute force: every pair is a candidate
+		long long bruteCandidates = 0;
+		int brutePairs = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (k = 0; k < BENCHMARK_ITERATIONS; ++k)
+		{
+			brutePairs = 0;
+			for (i = 0; i < count; ++i)
+			{
+				for (j = i + 1; j < count; ++j)
+				{
+					if (boxes[i].TestAABB(boxes[j])) brutePairs++;
+				}
+			}
+		}
+		double bruteMs = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+		bruteCandidates = (long long)count * (count - 1) / 2;
+
+		//Spatial hash: rebuilt and queried as in a game frame
+		int hashCandidates = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (k = 0; k < BENCHMARK_ITERATIONS; ++k)
+		{
+			hash.Clear();
+			for (i = 0; i < count; ++i)
+			{
+				hash.Insert(i, boxes[i], ColliderLayer::ENEMY);
+			}
+			hash.Build();
+			pairs.clear();
+			hash.QueryPairs(ColliderLayer::ENEMY, ColliderLayer::ENEMY, pairs);
+			hashCandidates = hash.GetCandidateCount();
+		}
+		double hashMs = ElapsedMs(start) / BENCHMARK_ITERATIONS;
+
+		LOG("Broadphase %5d entities: brute %lld candidates %d pairs %.3f ms | hash %d candidates %d pairs %.3f ms",
+			count, bruteCandidates, brutePairs, bruteMs, hashCandidates, (int)pairs.size(), hashMs);
+		if (brutePairs != (int)pairs.size())
+		{
+			LOG("Broadphase mismatch with %d entities", count);
+		}
+	}
+}
+void RunAABBBatchBenchmark()
+{
+	const int counts[] = { 100, 1000, 10000 };
+
+	std::mt19937 rng(5678);
+	AABBBatch batch;
+	std::vector<unsigned int> mask;
+
+	for (int count : counts)
+	{
+		std::vector<AABB> boxes = RandomBoxes(count, rng);
+		std::vector<AABB> queries = RandomBoxes(BENCHMARK_QUERIES, rng);
+		int i, q;
+
+		batch.Clear();
+		for (i = 0; i < count; ++i)
+		{
+			batch.Add(boxes[i]);
+		}
+
+		//Scalar loop as written in the game code
+		int scalarHits = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (q = 0; q < BENCHMARK_QUERIES; ++q)
+		{
+			for (i = 0; i < count; ++i)
+			{
+				if (queries[q].TestAABB(boxes[i])) scalarHits++;
+			}
+		}
+		double scalarMs = ElapsedMs(start);
+
+		//Batch kernel, hits are counted from the returned bitmask
+		int batchHits = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (q = 0; q < BENCHMARK_QUERIES; ++q)
+		{
+			batch.Test(queries[q], mask);
+			for (unsigned int bits : mask)
+			{
+				for (; bits != 0; bits &= bits - 1) batchHits++;
+			}
+		}
+		double batchMs = ElapsedMs(start);
+
+		LOG("AABB batch %5d boxes x %d queries: scalar %d hits %.3f ms | batch %d hits %.3f ms",
+			count, BENCHMARK_QUERIES, scalarHits, scalarMs, batchHits, batchMs);
+		if (scalarHits != batchHits)
+		{
+			LOG("AABB batch mismatch with %d boxes", count);
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+//Number of timed repetitions for each benchmark case
+#define BENCHMARK_ITERATIONS	10
+
+//Compare brute force against the spatial hash for 100, 1000 and 10000 random colliders,
+//candidate pairs and timings are written to the log
+void RunBroadphaseBenchmark();
+
+//Query boxes tested against each batch in the AABB benchmark
+#define BENCHMARK_QUERIES	1000
+
+//Compare the scalar AABB loop against the SIMD batch for 100, 1000 and 10000 boxes
+void RunAABBBatchBenchmark();
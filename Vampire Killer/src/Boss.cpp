@@ -1,7 +1,8 @@
 #include "Boss.h"
-#include "EnemyManager.h"
+#include "World.h"
+#include "Snapshot.h"
 
-Boss::Boss(Point pos) : Enemy(pos, BOSS_HITBOX_HEIGHT, BOSS_HITBOX_WIDTH, BOSS_SPRITE_HEIGHT, BOSS_SPRITE_WIDTH)
+Boss::Boss(Point pos, World* world) : Enemy(pos, BOSS_HITBOX_HEIGHT, BOSS_HITBOX_WIDTH, BOSS_SPRITE_HEIGHT, BOSS_SPRITE_WIDTH, world)
 {
 	state = EnemyState::ADVANCING;
 	look = EnemyLook::RIGHT;
@@ -16,6 +17,7 @@ Boss::Boss(Point pos) : Enemy(pos, BOSS_HITBOX_HEIGHT, BOSS_HITBOX_WIDTH, BOSS_S
 
 Boss::~Boss()
 {
+	Release();
 }
 
 AppStatus Boss::Initialise()
@@ -61,7 +63,7 @@ void Boss::Update()
 {
 	if (killed) {
 		isActive = false;
-		EnemyManager::Instance().target->IncrScore(2000);
+		Emit(EventType::ENEMY_KILLED, 2000);
 	}
 	else {
 		if (justHit) {
@@ -90,35 +92,36 @@ void Boss::Reset()
 
 void Boss::Brain()
 {
-	internalTimer += GetFrameTime();
+	wavePhase += waveStep;
 	
-	if (pos.x == 232)
+	if (pos.x >= 232)
 	{
 		Moving = false;
 	}
-	if (pos.x == 25)
+	if (pos.x <= 25)
 	{
 		Moving = true;
 	}
 
 	Move();
+	if (!nearTarget) return;
 
-	if (EnemyManager::Instance().target->GetState() == State::JUMPING || EnemyManager::Instance().target->GetState() == State::FALLING) {
+	if (world->enemies.target->GetState() == State::JUMPING || world->enemies.target->GetState() == State::FALLING) {
 	
-		if(this->GetHitbox().TestAABB(EnemyManager::Instance().target->GetHitbox())) {
+		if(this->GetHitbox().TestAABB(world->enemies.target->GetHitbox())) {
 			DamagePlayer();
 		}
 	}
-	else if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->GetHitbox())) {
+	else if (this->GetHitbox().TestAABB(world->enemies.target->GetHitbox())) {
 		DamagePlayer();
 	}
-	if (EnemyManager::Instance().target->weapon->GetFrame() == 2) {
-		if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->weapon->HitboxOnAttack())) {
-			AudioPlayer::Instance().PlaySoundByName("Attack");
-			if (EnemyManager::Instance().target->weapon->GetWeaponType() == WeaponType::WHIP) {
+	if (world->enemies.target->weapon->GetFrame() == 2) {
+		if (this->GetHitbox().TestAABB(world->enemies.target->weapon->HitboxOnAttack())) {
+			Emit(EventType::ENEMY_HIT, 0);
+			if (world->enemies.target->weapon->GetWeaponType() == WeaponType::WHIP) {
 				life -= 2;
 			}
-			else if (EnemyManager::Instance().target->weapon->GetWeaponType() == WeaponType::CHAIN) {
+			else if (world->enemies.target->weapon->GetWeaponType() == WeaponType::CHAIN) {
 				life -= 3;
 			}
 			if (life <= 0) {
@@ -126,7 +129,7 @@ void Boss::Brain()
 				life = 0;
 			}
 			justHit = true;
-			hitCounter = 30;
+			hitCounter = BOSS_HIT_TIME;
 		}
 	}
 }
@@ -145,16 +148,16 @@ void Boss::Move()
 {
 	if (Moving)
 	{
-		pos.x += BOSS_SPEED;
+		pos.x += StepX(BOSS_SPEED);
 	}
 	if (!Moving)
 	{
-		pos.x -= BOSS_SPEED;
+		pos.x += StepX(-BOSS_SPEED);
 	}
 
-	currentAmplitude = amplitude * sin(internalTimer * amplitudeChangeSpeed);
+	currentAmplitude = amplitude * FixedSin(wavePhase) / FIXED_ONE;
 
-	pos.y = Init_pos_y + currentAmplitude * TILE_SIZE;
+	pos.y = Init_pos_y + currentAmplitude;
 
 
 	//AABB box = this->GetHitbox();
@@ -163,10 +166,10 @@ void Boss::Move()
 	//{
 	//	if (ToCalculateVec)
 	//	{
-	//		vec = { (float)GetRandomValue(-1,1),(float)GetRandomValue(-3, 3) };
-	//		counter = 30 * GetRandomValue(1, 2);
+	//		vec = { (float)world->random.Range(-1,1),(float)world->random.Range(-3, 3) };
+	//		counter = 30 * world->random.Range(1, 2);
 	//		ToCalculateVec = false;
-	//		Straight_or_curve = GetRandomValue(0, 1);
+	//		Straight_or_curve = world->random.Range(0, 1);
 	//		
 	//	}
 	//	if (counter >= 0 && Straight_or_curve == 1)
@@ -179,8 +182,8 @@ void Boss::Move()
 	//	{
 	//		pos.x += vec.x;
 
-	//		currentAmplitude = amplitude * sin(internalTimer * amplitudeChangeSpeed);
-	//		pos.y = Init_pos_y + currentAmplitude * TILE_SIZE;
+	//		currentAmplitude = amplitude * FixedSin(wavePhase) / FIXED_ONE;
+	//		pos.y = Init_pos_y + currentAmplitude;
 	//			
 	//		counter--;
 	//	}*/
@@ -194,7 +197,7 @@ void Boss::Move()
 	//	vec.x = -vec.x;
 	//	vec.y = -vec.y;
 
-	//	/*counter = 30 * GetRandomValue(1, 3);*/
+	//	/*counter = 30 * world->random.Range(1, 3);*/
 
 	//	ToCalculateVec = false;
 
@@ -232,5 +235,39 @@ void Boss::Release()
 	data.ReleaseTexture(Resource::IMG_BOSS);
 	render->Release();
 }
-
-
+void Boss::SaveState(BinaryWriter& out) const
+{
+	Enemy::SaveState(out);
+	out.Write(life);
+	out.WriteBool(justHit);
+	out.Write(hitCounter);
+	out.Write(counter);
+	out.Write(Straight_or_curve);
+	out.Write(Curve_Up_or_Down);
+	out.WriteBool(Moving);
+	out.WriteBool(ToCalculateVec);
+	out.Write(vec);
+	out.Write(Init_pos_y);
+	out.Write(wavePhase);
+	out.Write(amplitude);
+	out.Write(currentAmplitude);
+	out.Write(waveStep);
+}
+void Boss::LoadState(BinaryReader& in)
+{
+	Enemy::LoadState(in);
+	in.Read(life);
+	in.ReadBool(justHit);
+	in.Read(hitCounter);
+	in.Read(counter);
+	in.Read(Straight_or_curve);
+	in.Read(Curve_Up_or_Down);
+	in.ReadBool(Moving);
+	in.ReadBool(ToCalculateVec);
+	in.Read(vec);
+	in.Read(Init_pos_y);
+	in.Read(wavePhase);
+	in.Read(amplitude);
+	in.Read(currentAmplitude);
+	in.Read(waveStep);
+}
@@ -1,8 +1,13 @@
 #pragma once
 #include "Enemy.h"
-#include "math.h"
+#include "FixedMath.h"
 
-#define BOSS_SPEED	1
+//Flying speed in pixels per second
+#define BOSS_SPEED	60
+
+//Height in pixels and speed in radians per second of the flying wave
+#define BOSS_WAVE_AMPLITUDE	(TILE_SIZE * 5 / 2)
+#define BOSS_WAVE_SPEED		3
 
 #define BOSS_SPRITE_HEIGHT	32
 #define BOSS_SPRITE_WIDTH	64
@@ -12,11 +17,14 @@
 
 #define BOSS_DAMAGE			6
 
+//Time the boss flashes after being hit
+#define BOSS_HIT_TIME		TIME_TO_TICKS(0.5)
+
 class Boss : public Enemy
 {
 public:
 
-	Boss(Point pos);
+	Boss(Point pos, World* world);
 	virtual ~Boss();
 
 	AppStatus Initialise();
@@ -36,28 +44,32 @@ public:
 	void DrawDebug(const Color& col) const override;
 	void Release() override;
 
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
+
 private:
 
 	int life = 16;
 
 	bool justHit = false;
-	int hitCounter = 30;
+	int hitCounter = BOSS_HIT_TIME;
 
-	int counter;
-	int Straight_or_curve;
-	int Curve_Up_or_Down;
+	int counter = 0;
+	int Straight_or_curve = 0;
+	int Curve_Up_or_Down = 0;
 
 	bool Moving = false;
 
 	bool ToCalculateVec = true;
-	Vector2 vec;
+	Vector2 vec = { 0, 0 };
 
 	TileMap* map;
-	int Init_pos_y;
+	int Init_pos_y = 0;
 
-	float internalTimer = 0;
-	float amplitude = 2.5;
-	float currentAmplitude = 0;
-	float amplitudeChangeSpeed = 3;
+	//Wave phase as an angle, advanced a fixed step every update
+	unsigned int wavePhase = 0;
+	int amplitude = BOSS_WAVE_AMPLITUDE;
+	int currentAmplitude = 0;
+	unsigned int waveStep = ANGLE_STEP(BOSS_WAVE_SPEED);
 };
 
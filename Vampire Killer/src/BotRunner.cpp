@@ -0,0 +1,439 @@
+#include "BotRunner.h"
+#include "JobSystem.h"
+#include "ResourceManager.h"
+#include "World.h"
+#include "RenderQueue.h"
+#include "SoftwareRenderer.h"
+#include "FrameArena.h"
+#include "MemTracker.h"
+#include <chrono>
+#include <vector>
+
+void BotStats::Merge(const BotStats& other)
+{
+	simulations += other.simulations;
+	ticks += other.ticks;
+	for (int stage = 0; stage < ROOM_STAGES; ++stage)
+	{
+		for (int floor = 0; floor < ROOM_FLOORS; ++floor)
+		{
+			deaths[stage][floor] += other.deaths[stage][floor];
+			falls[stage][floor] += other.falls[stage][floor];
+		}
+	}
+	game_overs += other.game_overs;
+	wins += other.wins;
+	hearts += other.hearts;
+	diverged += other.diverged;
+	frames_diverged += other.frames_diverged;
+	boss_reached += other.boss_reached;
+	ticks_to_boss += other.ticks_to_boss;
+	steady_ticks += other.steady_ticks;
+	steady_allocations += other.steady_allocations;
+	arena_overflows += other.arena_overflows;
+	if (other.arena_peak > arena_peak) arena_peak = other.arena_peak;
+	busy_seconds += other.busy_seconds;
+}
+
+//Area of a room, in tiles, where the scripted policy holds other buttons than walking right
+enum class RouteKey { ANY, MISSING, HELD };
+struct RouteStep
+{
+	int stage, floor;
+	int col0, col1, row0, row1;
+	RouteKey key;
+	unsigned int buttons;
+};
+
+#define ROUTE_RIGHT		BUTTON_MASK(Button::RIGHT)
+#define ROUTE_LEFT		BUTTON_MASK(Button::LEFT)
+#define ROUTE_UP		BUTTON_MASK(Button::UP)
+#define ROUTE_WHIP		BUTTON_MASK(Button::WHIP)
+
+//The castle is crossed through the upper exits, the boss door needs the key walled in the floor of 6-0,
+//from there 7-0 leads to the floor of 7-1, which is left back to the stairs of 6-1
+static const RouteStep route[] = {
+	{ 5, 0,  4,  6,  9, 11, RouteKey::ANY,		ROUTE_RIGHT | ROUTE_UP },
+	{ 5, 0,  6, 18,  9, 11, RouteKey::ANY,		ROUTE_LEFT },
+	{ 5, 0, 10, 11,  5,  7, RouteKey::ANY,		ROUTE_RIGHT | ROUTE_UP },
+	{ 6, 0, 12, 13,  6,  7, RouteKey::ANY,		ROUTE_RIGHT },
+	{ 6, 0, 11, 12,  9, 11, RouteKey::MISSING,	ROUTE_LEFT | ROUTE_WHIP },
+	{ 6, 0,  0, 18,  9, 11, RouteKey::MISSING,	ROUTE_LEFT },
+	{ 7, 0,  3,  5,  9, 11, RouteKey::ANY,		ROUTE_RIGHT | ROUTE_UP },
+	{ 7, 0,  5, 18,  9, 11, RouteKey::ANY,		ROUTE_LEFT },
+	{ 7, 0, 11, 12,  6,  7, RouteKey::ANY,		ROUTE_LEFT | ROUTE_UP },
+	{ 7, 0, 12, 18,  6,  7, RouteKey::ANY,		ROUTE_LEFT },
+	{ 7, 0,  4,  6,  2,  3, RouteKey::ANY,		ROUTE_RIGHT | ROUTE_UP },
+	{ 7, 0,  6, 18,  2,  3, RouteKey::ANY,		ROUTE_LEFT },
+	{ 7, 1,  0, 18,  9, 11, RouteKey::ANY,		ROUTE_LEFT },
+	{ 6, 1,  8, 10,  9, 11, RouteKey::ANY,		ROUTE_RIGHT | ROUTE_UP },
+	{ 6, 1, 10, 18,  9, 11, RouteKey::ANY,		ROUTE_LEFT },
+	{ 7, 1, 10, 11,  5,  7, RouteKey::ANY,		ROUTE_RIGHT | ROUTE_UP },
+};
+
+//Policies return the buttons held during the tick
+static unsigned int ScriptedPolicy(int tick, const Scene& scene, unsigned int previous)
+{
+	const Player* player = scene.GetPlayer();
+	if (player->GetState() == State::CLIMBING)
+	{
+		return ROUTE_UP | (player->IsLookingRight() ? ROUTE_RIGHT : ROUTE_LEFT);
+	}
+
+	//Walk right through the stages attacking at a steady rate unless the route says otherwise
+	Point pos = player->GetPos();
+	int col = pos.x / TILE_SIZE;
+	int row = pos.y / TILE_SIZE;
+	RouteKey key = player->HasDoorKey() ? RouteKey::HELD : RouteKey::MISSING;
+	unsigned int buttons = ROUTE_RIGHT;
+	for (const RouteStep& step : route)
+	{
+		if (step.stage == scene.GetCurrentLevel() && step.floor == scene.GetCurrentFloor() &&
+			col >= step.col0 && col < step.col1 && row >= step.row0 && row < step.row1 &&
+			(step.key == RouteKey::ANY || step.key == key))
+		{
+			buttons = step.buttons;
+			break;
+		}
+	}
+
+	//Stairs are only taken on a fresh press, holding up on the ground keeps jumping
+	if ((buttons & ROUTE_UP) && (previous & ROUTE_UP))	buttons &= ~ROUTE_UP;
+	else if (tick % BOT_WHIP_PERIOD == 0)					buttons |= ROUTE_WHIP;
+	return buttons;
+}
+//Draws from the game's own stream, the standard distributions differ between libraries and the
+//recorded runs must verify on every build
+static unsigned int RandomWalkPolicy(Random& rng, unsigned int& walk, int& walk_ticks)
+{
+	if (walk_ticks <= 0)
+	{
+		//Biased to the right so the walk makes progress through the stages
+		int c = rng.Range(0, 9);
+		if (c < 6)		walk = BUTTON_MASK(Button::RIGHT);
+		else if (c < 8)	walk = BUTTON_MASK(Button::LEFT);
+		else			walk = 0;
+
+		walk_ticks = rng.Range(BOT_WALK_MIN_TICKS, BOT_WALK_MAX_TICKS);
+	}
+	walk_ticks--;
+
+	unsigned int buttons = walk;
+	int a = rng.Range(0, 99);
+	if (a < 6)			buttons |= BUTTON_MASK(Button::WHIP);
+	else if (a < 8)		buttons |= BUTTON_MASK(Button::THROW);
+	else if (a < 11)	buttons |= BUTTON_MASK(Button::UP);
+	else if (a < 13)	buttons |= BUTTON_MASK(Button::DOWN);
+	return buttons;
+}
+AppStatus BotRunner::Run(const BotConfig& config, BotStats& stats)
+{
+	if (!ResourceManager::Instance().IsHeadless())
+	{
+		LOG("Bot runner needs the resource manager in headless mode");
+		return AppStatus::ERROR;
+	}
+
+	std::vector<BotStats> results(config.simulations);
+	std::vector<AppStatus> status(config.simulations, AppStatus::OK);
+
+	std::vector<HashTrace> reference;
+	std::vector<HashTrace> hashes(config.record_hashes != nullptr ? config.simulations : 0);
+	if (config.verify_hashes != nullptr)
+	{
+		if (LoadHashes(config.verify_hashes, config, reference) != AppStatus::OK) return AppStatus::ERROR;
+	}
+	std::vector<HashTrace> frame_reference;
+	std::vector<HashTrace> frame_hashes(config.record_frames != nullptr ? config.simulations : 0);
+	if (config.verify_frames != nullptr)
+	{
+		if (LoadHashes(config.verify_frames, config, frame_reference) != AppStatus::OK) return AppStatus::ERROR;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	//Results are written to a slot per simulation, nothing is shared while they run
+	JobSystem& jobs = JobSystem::Instance();
+	JobCounter counter;
+	for (int i = 0; i < config.simulations; ++i)
+	{
+		SimulationTraces traces;
+		traces.state_reference = reference.empty() ? nullptr : &reference[i];
+		traces.state_hashes = hashes.empty() ? nullptr : &hashes[i];
+		traces.frame_reference = frame_reference.empty() ? nullptr : &frame_reference[i];
+		traces.frame_hashes = frame_hashes.empty() ? nullptr : &frame_hashes[i];
+		jobs.Submit([&config, &results, &status, traces, i]() {
+			status[i] = Simulate(config, config.seed + i, traces, results[i]);
+		}, counter);
+	}
+	jobs.Wait(counter);
+
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	AppStatus result = AppStatus::OK;
+	for (int i = 0; i < config.simulations; ++i)
+	{
+		if (status[i] != AppStatus::OK) result = AppStatus::ERROR;
+		stats.Merge(results[i]);
+	}
+	stats.wall_seconds += elapsed.count();
+
+	if (config.record_hashes != nullptr)
+	{
+		if (SaveHashes(config.record_hashes, config, hashes) != AppStatus::OK) result = AppStatus::ERROR;
+	}
+	if (config.record_frames != nullptr)
+	{
+		if (SaveHashes(config.record_frames, config, frame_hashes) != AppStatus::OK) result = AppStatus::ERROR;
+	}
+	return result;
+}
+AppStatus BotRunner::Simulate(const BotConfig& config, unsigned int seed, const SimulationTraces& traces, BotStats& stats)
+{
+	const HashTrace* reference = traces.state_reference;
+	HashTrace* hashes = traces.state_hashes;
+	auto start = std::chrono::high_resolution_clock::now();
+
+	World world(false, seed);
+	Scene scene(&world);
+	scene.EnableRewind(false);
+	if (scene.Init() != AppStatus::OK)
+	{
+		LOG("Bot %u: failed to initialise Scene", seed);
+		return AppStatus::ERROR;
+	}
+
+	//Separate from the world's stream so the policy doesn't change what the game draws
+	Random rng(seed);
+	unsigned int buttons = 0;
+	unsigned int walk = 0;
+	int walk_ticks = 0;
+
+	const Player* player = scene.GetPlayer();
+	int lives = player->GetLives();
+	int hearts = player->GetHearts();
+	int stage = scene.GetCurrentLevel();
+	int floor = scene.GetCurrentFloor();
+	bool boss = false;
+	bool diverged = false;
+
+	//Rendering doesn't change the game state, drawing the frames or not plays the same game
+	bool render = traces.frame_reference != nullptr || traces.frame_hashes != nullptr;
+	bool frames_diverged = false;
+	SoftwareRenderer renderer;
+	RenderQueue& queue = RenderQueue::Instance();
+	if (render) queue.SetSoftwareTarget(&renderer);
+
+	//Traces are allocated up front, the ticks are measured for heap allocations
+	if (hashes != nullptr) hashes->reserve(config.max_ticks);
+	if (traces.frame_hashes != nullptr) traces.frame_hashes->reserve(config.max_ticks);
+	FrameArena& arena = FrameArena::Instance();
+
+	int tick = 0;
+	for (; tick < config.max_ticks; ++tick)
+	{
+		arena.Reset();
+		unsigned long long allocations = MemTracker::GetThreadAllocations();
+
+		if (config.policy == BotPolicy::SCRIPTED)	buttons = ScriptedPolicy(tick, scene, buttons);
+		else										buttons = RandomWalkPolicy(rng, walk, walk_ticks);
+		world.input.Set(buttons);
+
+		scene.Update();
+
+		if (reference != nullptr || hashes != nullptr)
+		{
+			unsigned long long hash = scene.GetStateHash();
+			if (hashes != nullptr) hashes->push_back(hash);
+			if (reference != nullptr && !diverged && (tick >= (int)reference->size() || (*reference)[tick] != hash))
+			{
+				LOG("Bot %u: state diverges from the reference at tick %d in room %d-%d", seed, tick,
+					scene.GetCurrentLevel(), scene.GetCurrentFloor());
+				diverged = true;
+			}
+		}
+		if (render)
+		{
+			//Same background as Game::Render()
+			renderer.Clear({ 6, 6, 6, 255 });
+			queue.BeginFrame();
+			scene.Render();
+
+			unsigned long long hash = renderer.GetHash();
+			if (traces.frame_hashes != nullptr) traces.frame_hashes->push_back(hash);
+			const HashTrace* frames = traces.frame_reference;
+			if (frames != nullptr && !frames_diverged && (tick >= (int)frames->size() || (*frames)[tick] != hash))
+			{
+				LOG("Bot %u: frame differs from the reference at tick %d in room %d-%d", seed, tick,
+					scene.GetCurrentLevel(), scene.GetCurrentFloor());
+				char path[64];
+				snprintf(path, sizeof(path), "frame_%u_%d.png", seed, tick);
+				renderer.Export(path);
+				frames_diverged = true;
+			}
+		}
+
+		//Loading a room allocates, only the ticks played inside a room are expected not to
+		if (player->GetLives() == lives && scene.GetCurrentLevel() == stage && scene.GetCurrentFloor() == floor)
+		{
+			stats.steady_ticks++;
+			stats.steady_allocations += MemTracker::GetThreadAllocations() - allocations;
+		}
+
+		//A respawn takes a life and reloads the first room of the section in the same tick while the last death
+		//keeps the lives at zero, either way the death belongs to the room before
+		bool game_over = scene.PlayerIsDead();
+		if (player->GetLives() < lives || game_over)
+		{
+			stats.deaths[stage][floor]++;
+		}
+		else if (player->GetHearts() > hearts)
+		{
+			stats.hearts += player->GetHearts() - hearts;
+		}
+		lives = player->GetLives();
+		hearts = player->GetHearts();
+		stage = scene.GetCurrentLevel();
+		floor = scene.GetCurrentFloor();
+
+		if (!boss && stage == ROOM_STAGES - 1)
+		{
+			boss = true;
+			stats.boss_reached++;
+			stats.ticks_to_boss += tick + 1;
+		}
+		if (player->GetPos().y > BOT_FALL_LIMIT)
+		{
+			LOG("Bot %u: fell out of room %d-%d at tick %d", seed, stage, floor, tick);
+			stats.falls[stage][floor]++;
+			tick++;
+			break;
+		}
+		if (game_over)
+		{
+			stats.game_overs++;
+			tick++;
+			break;
+		}
+		if (scene.PlayerHasWon())
+		{
+			stats.wins++;
+			tick++;
+			break;
+		}
+	}
+	scene.Release();
+	if (render) queue.SetSoftwareTarget(nullptr);
+
+	//The reference kept playing after this simulation stopped
+	if (reference != nullptr && !diverged && tick < (int)reference->size())
+	{
+		LOG("Bot %u: state diverges from the reference at tick %d, the simulation ended early", seed, tick);
+		diverged = true;
+	}
+	if (traces.frame_reference != nullptr && !frames_diverged && tick < (int)traces.frame_reference->size())
+	{
+		LOG("Bot %u: frames differ from the reference at tick %d, the simulation ended early", seed, tick);
+		frames_diverged = true;
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	stats.simulations = 1;
+	stats.ticks = tick;
+	stats.busy_seconds = elapsed.count();
+	stats.diverged = diverged ? 1 : 0;
+	stats.frames_diverged = frames_diverged ? 1 : 0;
+	stats.arena_overflows = arena.GetOverflows();
+	stats.arena_peak = arena.GetPeak();
+	return AppStatus::OK;
+}
+AppStatus BotRunner::SaveHashes(const char* path, const BotConfig& config, const std::vector<HashTrace>& traces)
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+	{
+		LOG("Failed to open hash file %s", path);
+		return AppStatus::ERROR;
+	}
+	fprintf(file, "seed tick hash\n");
+	for (int i = 0; i < (int)traces.size(); ++i)
+	{
+		for (int tick = 0; tick < (int)traces[i].size(); ++tick)
+		{
+			fprintf(file, "%u %d %016llx\n", config.seed + i, tick, traces[i][tick]);
+		}
+	}
+	fclose(file);
+	LOG("Saved the state hashes of %d simulations to %s", (int)traces.size(), path);
+	return AppStatus::OK;
+}
+AppStatus BotRunner::LoadHashes(const char* path, const BotConfig& config, std::vector<HashTrace>& traces)
+{
+	FILE* file = fopen(path, "r");
+	if (file == nullptr)
+	{
+		LOG("Failed to open hash file %s", path);
+		return AppStatus::ERROR;
+	}
+	traces.assign(config.simulations, HashTrace());
+
+	//Lines of the seeds that are not simulated in this run are skipped
+	char line[128];
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		unsigned int seed;
+		int tick;
+		unsigned long long hash;
+		if (sscanf(line, "%u %d %llx", &seed, &tick, &hash) != 3) continue;
+		if (seed < config.seed || seed - config.seed >= (unsigned int)config.simulations) continue;
+
+		HashTrace& trace = traces[seed - config.seed];
+		if (tick != (int)trace.size())
+		{
+			LOG("Hash file %s: tick %d of seed %u out of order", path, tick, seed);
+			fclose(file);
+			return AppStatus::ERROR;
+		}
+		trace.push_back(hash);
+	}
+	fclose(file);
+	return AppStatus::OK;
+}
+void BotRunner::Report(const BotStats& stats)
+{
+	LOG("Bots: %d simulations, %lld ticks in %.2f s", stats.simulations, stats.ticks, stats.wall_seconds);
+	if (stats.busy_seconds > 0.0)
+	{
+		LOG("Bots: %.0f ticks/s per core, %.0f ticks/s total", stats.ticks / stats.busy_seconds,
+			stats.wall_seconds > 0.0 ? stats.ticks / stats.wall_seconds : 0.0);
+	}
+	LOG("Bots: %d wins, %d game overs, %d hearts collected", stats.wins, stats.game_overs, stats.hearts);
+	if (stats.steady_ticks > 0)
+	{
+		LOG("Bots: %lld heap allocations in %lld ticks inside a room (%.3f per tick), frame arena peak %zu bytes, %d overflows",
+			stats.steady_allocations, stats.steady_ticks, (double)stats.steady_allocations / stats.steady_ticks,
+			stats.arena_peak, stats.arena_overflows);
+	}
+	if (stats.diverged > 0) LOG("Bots: %d simulations diverged from the reference hashes", stats.diverged);
+	if (stats.frames_diverged > 0) LOG("Bots: %d simulations drew frames that differ from the reference", stats.frames_diverged);
+	if (stats.boss_reached > 0)
+	{
+		LOG("Bots: %d reached the boss in %.0f ticks on average", stats.boss_reached,
+			(double)stats.ticks_to_boss / stats.boss_reached);
+	}
+	else
+	{
+		LOG("Bots: none reached the boss");
+	}
+	for (int stage = 1; stage < ROOM_STAGES; ++stage)
+	{
+		for (int floor = 0; floor < ROOM_FLOORS; ++floor)
+		{
+			if (stats.deaths[stage][floor] > 0 || stats.falls[stage][floor] > 0)
+			{
+				LOG("Bots: room %d-%d, %d deaths, %d fell out of the map", stage, floor,
+					stats.deaths[stage][floor], stats.falls[stage][floor]);
+			}
+		}
+	}
+}
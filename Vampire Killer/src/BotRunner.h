@@ -0,0 +1,101 @@
+#pragma once
+#include "Globals.h"
+#include "Scene.h"
+
+//Ticks simulated by each bot when no limit is given (10 minutes of game time)
+#define BOT_DEFAULT_TICKS		TIME_TO_TICKS(10 * 60)
+
+//Ticks a random walk keeps the same direction, at least the minimum
+#define BOT_WALK_MIN_TICKS		TIME_TO_TICKS(0.5)
+#define BOT_WALK_MAX_TICKS		TIME_TO_TICKS(2.0)
+
+//Ticks between attacks of the scripted policy
+#define BOT_WHIP_PERIOD			TIME_TO_PERIOD(1.0)
+
+//A player this far below the playable area has fallen out of the map, the simulation is stopped
+#define BOT_FALL_LIMIT			(LEVEL_HEIGHT * TILE_SIZE + WINDOW_HEIGHT)
+
+enum class BotPolicy { SCRIPTED, RANDOM_WALK };
+
+struct BotConfig
+{
+    int simulations = 1;
+    int max_ticks = BOT_DEFAULT_TICKS;
+    BotPolicy policy = BotPolicy::SCRIPTED;
+    unsigned int seed = 1;
+
+    //Optional files with the state hash of every tick, one line per tick: seed tick hash
+    //The recorded file of a reference build verifies that another build plays bit-identical games
+    const char* record_hashes = nullptr;
+    const char* verify_hashes = nullptr;
+
+    //Same for the frame drawn by the software renderer after every tick, used to catch rendering
+    //changes without a GPU. The first frame of a simulation that differs is saved as frame_<seed>_<tick>.png
+    const char* record_frames = nullptr;
+    const char* verify_frames = nullptr;
+};
+
+//State or frame hash of every simulated tick of one simulation
+typedef std::vector<unsigned long long> HashTrace;
+
+//Traces of one simulation, nullptr when not recorded or verified
+struct SimulationTraces
+{
+    const HashTrace* state_reference = nullptr;
+    HashTrace* state_hashes = nullptr;
+    const HashTrace* frame_reference = nullptr;
+    HashTrace* frame_hashes = nullptr;
+};
+
+//Aggregated results of one or several simulations
+struct BotStats
+{
+    int simulations = 0;
+    long long ticks = 0;
+    int deaths[ROOM_STAGES][ROOM_FLOORS] = {};
+    int falls[ROOM_STAGES][ROOM_FLOORS] = {};
+    int game_overs = 0;
+    int wins = 0;
+    int hearts = 0;
+
+    //Simulations whose state or frame hashes differ from the reference
+    int diverged = 0;
+    int frames_diverged = 0;
+
+    //Simulations that reached the boss room and the sum of the ticks they needed
+    int boss_reached = 0;
+    long long ticks_to_boss = 0;
+
+    //Ticks that stayed in the same room and the heap allocations they made, a steady-state
+    //tick should take its temporaries from the frame arena and not allocate at all
+    long long steady_ticks = 0;
+    long long steady_allocations = 0;
+    //Allocations that didn't fit in the frame arena and its peak use in bytes
+    int arena_overflows = 0;
+    size_t arena_peak = 0;
+
+    //Time spent simulating, each simulation runs on a single core
+    double busy_seconds = 0.0;
+    double wall_seconds = 0.0;
+
+    void Merge(const BotStats& other);
+};
+
+//Runs complete games without window, audio or rendering, one simulation per job,
+//so a soak test spreads across every core of the machine
+class BotRunner
+{
+public:
+    //Resources must be in headless mode and the job system initialised
+    static AppStatus Run(const BotConfig& config, BotStats& stats);
+
+    //Write the aggregated stats to the log
+    static void Report(const BotStats& stats);
+
+private:
+    //The state is only hashed and the frames only drawn when their traces are given
+    static AppStatus Simulate(const BotConfig& config, unsigned int seed, const SimulationTraces& traces, BotStats& stats);
+
+    static AppStatus SaveHashes(const char* path, const BotConfig& config, const std::vector<HashTrace>& traces);
+    static AppStatus LoadHashes(const char* path, const BotConfig& config, std::vector<HashTrace>& traces);
+};
@@ -6,6 +6,7 @@
 #include <raymath.h>
 #include "EnemyManager.h"
 #include "StaticImage.h"
+#include "Snapshot.h"
 
 Door::Door(Point pos) : Entity(pos, 6, 48, 6, 48)
 {
@@ -48,7 +49,7 @@ void Door::Render()
 void Door::Open()
 {
 	state = DoorState::OPEN;
-	pos.y--;
+	pos.y += StepY(-DOOR_SPEED);
 }
 void Door::DrawDebug(const Color& col) const
 {
@@ -60,4 +61,14 @@ void Door::Release()
 	data.ReleaseTexture(Resource::IMG_DOOR);
 
 	render->Release();
+}
+void Door::SaveState(BinaryWriter& out) const
+{
+	Entity::SaveState(out);
+	out.WriteEnum(state);
+}
+void Door::LoadState(BinaryReader& in)
+{
+	Entity::LoadState(in);
+	in.ReadEnum(state);
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "TileMap.h"
 #include "Player.h"
 
+//Opening speed in pixels per second
+#define DOOR_SPEED	60
+
 //Logic states
 enum class DoorState {
 	OPEN, CLOSED
@@ -25,6 +28,9 @@ public:
 	void DrawDebug(const Color& col) const;
 	void Release();
 
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
+
 protected:
 
 	DoorState state;
@@ -5,10 +5,16 @@
 #include "Globals.h"
 #include "Weapon.h"
 #include <raymath.h>
-#include "EnemyManager.h"
+#include "World.h"
+#include "Snapshot.h"
 
-Enemy::Enemy(Point pos, int height, int width, int frameheight, int framewidth) : Entity(pos, width, height, framewidth, frameheight)
+Enemy::Enemy(Point pos, int height, int width, int frameheight, int framewidth, World* world) : Entity(pos, width, height, framewidth, frameheight), world(world)
 {
+	state = EnemyState::IDLE;
+	look = EnemyLook::RIGHT;
+	type = EnemyType::ZOMBIE;
+	AnimationFrame = 0;
+	EnemySpeed = 0;
 	Damage = 0;
 }
 Enemy::~Enemy()
@@ -40,6 +46,10 @@ void Enemy::Release()
 {
 	render->Release();
 }
+bool Enemy::IsOnScreen() const
+{
+	return pos.x > 16 && pos.x < 256;
+}
 bool Enemy::IsKilled() const
 {
 	return killed;
@@ -50,6 +60,7 @@ Vector2 Enemy::GetKilledPosition() const
 		Vector2 killedPos = { (float)pos.x, (float)pos.y - 24 };
 		return killedPos;
 	}
+	return { (float)pos.x, (float)pos.y };
 }
 int Enemy::GetLife() const
 {
@@ -79,9 +90,54 @@ void Enemy::SetAnimation(int id)
 	Sprite* sprite = dynamic_cast<Sprite*>(render);
 	sprite->SetAnimation(id);
 }
-void Enemy::DamagePlayer() const
+void Enemy::DamagePlayer()
 {
-	EnemyManager::Instance().target->DecrLife(Damage);
+	Emit(EventType::PLAYER_DAMAGED, Damage);
+}
+void Enemy::Emit(EventType ev, int value)
+{
+	EmitItem(ev, ObjectType::CHAIN, value);
+}
+void Enemy::EmitItem(EventType ev, ObjectType item, int value)
+{
+	GameEvent e;
+	e.type = ev;
+	e.pos = pos;
+	e.value = value;
+	e.item = item;
+	e.enemy = type;
+	events.push_back(e);
+}
+void Enemy::FlushEvents()
+{
+	for (const GameEvent& e : events)
+	{
+		world->events.Push(e);
+	}
+	events.clear();
+}
+void Enemy::SaveState(BinaryWriter& out) const
+{
+	Entity::SaveState(out);
+	out.WriteEnum(state);
+	out.WriteEnum(look);
+	out.Write(AnimationFrame);
+	out.Write(EnemySpeed);
+	out.Write(Damage);
+	out.WriteBool(killed);
+	out.WriteBool(isActive);
+	//Computed by the broadphase of the previous update
+	out.WriteBool(nearTarget);
+}
+void Enemy::LoadState(BinaryReader& in)
+{
+	Entity::LoadState(in);
+	in.ReadEnum(state);
+	in.ReadEnum(look);
+	in.Read(AnimationFrame);
+	in.Read(EnemySpeed);
+	in.Read(Damage);
+	in.ReadBool(killed);
+	in.ReadBool(isActive);
+	in.ReadBool(nearTarget);
 }
-
-
@@ -3,6 +3,9 @@
 #include "Weapon.h"
 #include "TileMap.h"
 #include "Player.h"
+#include "EventBus.h"
+
+class World;
 
 //Logic states
 enum class EnemyState {
@@ -27,7 +30,7 @@ enum class EnemyAnim {
 class Enemy : public Entity
 {
 public:
-	Enemy(Point pos, int height, int width, int frameheight, int framewidth);
+	Enemy(Point pos, int height, int width, int frameheight, int framewidth, World* world);
 	virtual ~Enemy();
 
 	virtual AppStatus Initialise();
@@ -44,6 +47,8 @@ public:
 	virtual void Release();
 
 	bool IsKilled() const;
+	//Inside the part of the room where enemies live, they are deactivated once they leave it
+	bool IsOnScreen() const;
 
 	Vector2 GetKilledPosition() const;
 
@@ -55,12 +60,28 @@ public:
 
 	bool isActive = true;
 
+	//Set by the broadphase when the player or the weapon may touch this enemy
+	bool nearTarget = true;
+
+	//Push the events emitted during the last update to the event bus
+	void FlushEvents();
+
+	//Snapshot of the common logic state, subclasses append their own fields
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
+
 protected:
 
 	void Stop();
 	void SetAnimation(int id);
 
-	void DamagePlayer() const;
+	void DamagePlayer();
+	//Queue a gameplay event at the enemy position, kept in the enemy until FlushEvents()
+	//so enemies can be updated in parallel
+	void Emit(EventType ev, int value);
+	void EmitItem(EventType ev, ObjectType item, int value);
+
+	World* world;
 
 	EnemyState state;
 	EnemyLook look;
@@ -71,5 +92,7 @@ protected:
 	int Damage;
 
 	bool killed = false;
+
+	std::vector<GameEvent> events;
 };
 
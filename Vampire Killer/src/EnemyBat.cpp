@@ -1,9 +1,10 @@
 
 #include "EnemyBat.h"
-#include "EnemyManager.h"
+#include "World.h"
+#include "Snapshot.h"
 
 
-EnemyBat::EnemyBat(Point pos) : Enemy({ pos.x, pos.y }, BAT_HITBOX_HEIGHT, BAT_HITBOX_WIDTH, BAT_SPRITE_HEIGHT, BAT_SPRITE_WIDTH)
+EnemyBat::EnemyBat(Point pos, World* world) : Enemy({ pos.x, pos.y }, BAT_HITBOX_HEIGHT, BAT_HITBOX_WIDTH, BAT_SPRITE_HEIGHT, BAT_SPRITE_WIDTH, world)
 {
 	state = EnemyState::ADVANCING;
 	look = EnemyLook::RIGHT;
@@ -15,6 +16,7 @@ EnemyBat::EnemyBat(Point pos) : Enemy({ pos.x, pos.y }, BAT_HITBOX_HEIGHT, BAT_H
 }
 EnemyBat::~EnemyBat()
 {
+	Release();
 }
 AppStatus EnemyBat::Initialise()
 {
@@ -54,14 +56,14 @@ AppStatus EnemyBat::Initialise()
 	sprite->SetAnimationDelay((int)EnemyAnim::EMPTY, ANIM_DELAY);
 	sprite->AddKeyFrame((int)EnemyAnim::EMPTY, { 0, 0, 0, 0 });
 
-	if (EnemyManager::Instance().target->GetPos().x < 208 && EnemyManager::Instance().target->IsLookingRight()) {
+	if (world->enemies.target->GetPos().x < 208 && world->enemies.target->IsLookingRight()) {
 		SetPos({ 255, pos.y });
 		state = EnemyState::ADVANCING;
 		look = EnemyLook::LEFT;
 		SetAnimation((int)EnemyAnim::ADVANCING_LEFT);
 		Init_pos_y = pos.y;
 	}
-	else if (EnemyManager::Instance().target->GetPos().x > 68 && EnemyManager::Instance().target->IsLookingLeft()) {
+	else if (world->enemies.target->GetPos().x > 68 && world->enemies.target->IsLookingLeft()) {
 		SetPos({ 20, pos.y });
 		state = EnemyState::ADVANCING;
 		look = EnemyLook::RIGHT;
@@ -78,25 +80,20 @@ void EnemyBat::Update()
 {
 	if (killed) {
 		isActive = false;
-		EnemyManager::Instance().target->IncrScore(100);
+		Emit(EventType::ENEMY_KILLED, 100);
 	}
 	else {
 		Brain();
 		Sprite* sprite = dynamic_cast<Sprite*>(render);
 		sprite->Update();
+		if (!IsOnScreen()) isActive = false;
 	}
 }
 void EnemyBat::Render()
 {
-	if (pos.x > 16 && pos.x < 256)
-	{
+	if (!killed) {
 		Point p = GetRenderingPosition();
-		if (!killed) {
-			render->Draw(p.x, p.y);
-		}
-	}
-	else {
-		isActive = false;
+		render->Draw(p.x, p.y);
 	}
 }
 void EnemyBat::Reset()
@@ -104,21 +101,23 @@ void EnemyBat::Reset()
 }
 void EnemyBat::Brain()
 {
-	internalTimer += GetFrameTime();
+	wavePhase += waveStep;
 	Move();
-	if (EnemyManager::Instance().target->GetState() == State::JUMPING || EnemyManager::Instance().target->GetState() == State::FALLING) {
-		AABB PlayerHitbox = EnemyManager::Instance().target->GetHitbox();
-		PlayerHitbox.pos.y = EnemyManager::Instance().target->GetHitbox().pos.y - 16;
+	if (!nearTarget) return;
+
+	if (world->enemies.target->GetState() == State::JUMPING || world->enemies.target->GetState() == State::FALLING) {
+		AABB PlayerHitbox = world->enemies.target->GetHitbox();
+		PlayerHitbox.pos.y = world->enemies.target->GetHitbox().pos.y - 16;
 		if (this->GetHitbox().TestAABB(PlayerHitbox)) {
 			DamagePlayer();
 		}
 	}
-	else if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->GetHitbox())) {
+	else if (this->GetHitbox().TestAABB(world->enemies.target->GetHitbox())) {
 		DamagePlayer();
 	}
-	if (EnemyManager::Instance().target->weapon->GetFrame() == 2) {
-		if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->weapon->HitboxOnAttack())) {
-			AudioPlayer::Instance().PlaySoundByName("Attack");
+	if (world->enemies.target->weapon->GetFrame() == 2) {
+		if (this->GetHitbox().TestAABB(world->enemies.target->weapon->HitboxOnAttack())) {
+			Emit(EventType::ENEMY_HIT, 0);
 			killed = true;
 		}
 	}
@@ -151,15 +150,15 @@ void EnemyBat::Move()
 	}
 	else if (state == EnemyState::ADVANCING) {
 
-		currentAmplitude = amplitude * sin(internalTimer * amplitudeChangeSpeed);
+		currentAmplitude = amplitude * FixedSin(wavePhase) / FIXED_ONE;
 
-		pos.y = Init_pos_y + currentAmplitude * TILE_SIZE;
+		pos.y = Init_pos_y + currentAmplitude;
 
 		if (look == EnemyLook::RIGHT) {
-			pos.x += BAT_SPEED;
+			pos.x += StepX(BAT_SPEED);
 		}
 		else {
-			pos.x -= BAT_SPEED;
+			pos.x += StepX(-BAT_SPEED);
 		}
 	}
 	else if (state == EnemyState::DEAD) {
@@ -177,4 +176,21 @@ void EnemyBat::Release()
 
 	render->Release();
 }
-
+void EnemyBat::SaveState(BinaryWriter& out) const
+{
+	Enemy::SaveState(out);
+	out.Write(Init_pos_y);
+	out.Write(wavePhase);
+	out.Write(amplitude);
+	out.Write(currentAmplitude);
+	out.Write(waveStep);
+}
+void EnemyBat::LoadState(BinaryReader& in)
+{
+	Enemy::LoadState(in);
+	in.Read(Init_pos_y);
+	in.Read(wavePhase);
+	in.Read(amplitude);
+	in.Read(currentAmplitude);
+	in.Read(waveStep);
+}
@@ -1,8 +1,13 @@
 #pragma once
 #include "Enemy.h"
-#include "math.h"
+#include "FixedMath.h"
 
-#define BAT_SPEED	1
+//Flying speed in pixels per second
+#define BAT_SPEED	60
+
+//Height in pixels and speed in radians per second of the flying wave
+#define BAT_WAVE_AMPLITUDE	(TILE_SIZE * 3 / 4)
+#define BAT_WAVE_SPEED		3
 
 #define BAT_SPRITE_HEIGHT	32
 #define BAT_SPRITE_WIDTH	32
@@ -16,7 +21,7 @@ class EnemyBat : public Enemy
 {
 public:
 
-	EnemyBat(Point pos);
+	EnemyBat(Point pos, World* world);
 	virtual ~EnemyBat();
 
 	AppStatus Initialise();
@@ -36,15 +41,19 @@ public:
 	void DrawDebug(const Color& col) const override;
 	void Release() override;
 
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
+
 private:
 
 	TileMap* map;
-	int Init_pos_y;
+	int Init_pos_y = 0;
 
-	float internalTimer = 0;
-	float amplitude = 0.75;
-	float currentAmplitude = 0;
-	float amplitudeChangeSpeed = 3;
+	//Wave phase as an angle, advanced a fixed step every update
+	unsigned int wavePhase = 0;
+	int amplitude = BAT_WAVE_AMPLITUDE;
+	int currentAmplitude = 0;
+	unsigned int waveStep = ANGLE_STEP(BAT_WAVE_SPEED);
 
 };
 
@@ -4,17 +4,31 @@
 #include "EnemyManager.h"
 #include "Trader.h"
 #include "Boss.h"
+#include "JobSystem.h"
+#include "World.h"
+#include "Snapshot.h"
+#include "MemTracker.h"
 
-EnemyManager::EnemyManager() {
-	AudioPlayer::Instance().CreateSound("audio/SFX/27.wav", "Attack");
+EnemyManager::EnemyManager(World* world) : world(world) {
+	target = nullptr;
+	map = nullptr;
+	world->audio.CreateSound("audio/SFX/27.wav", "Attack", ResourceOwner::ENEMIES);
 }
 
 void EnemyManager::Update()
 {
-	for (int i = 0; i < enemies.size(); ++i) {
-		if (enemies[i]->isActive) {
-			enemies[i]->Update();
+	//Enemies only read the player and the map while updating, their events are buffered
+	JobSystem::Instance().ParallelFor((int)enemies.size(), ENEMY_UPDATE_GRAIN, [this](int begin, int end) {
+		for (int i = begin; i < end; ++i) {
+			if (enemies[i]->isActive) {
+				enemies[i]->Update();
+			}
 		}
+	});
+
+	//Merge the events in enemy order so the result doesn't depend on the thread timing
+	for (int i = 0; i < enemies.size(); ++i) {
+		enemies[i]->FlushEvents();
 	}
 }
 void EnemyManager::Reset()
@@ -38,27 +52,32 @@ void EnemyManager::SetTarget(Player* player)
 }
 void EnemyManager::SpawnZombie(Point pos)
 {
-	Enemy* newEnemy = new EnemyZombie(pos);
+	MemScope scope(MemTag::ENTITIES);
+	Enemy* newEnemy = arena.Create<EnemyZombie>(pos, world);
 	enemies.push_back(newEnemy);
 }
 void EnemyManager::SpawnPanther(Point pos)
 {
-	Enemy* newEnemy = new EnemyPanther(pos);
+	MemScope scope(MemTag::ENTITIES);
+	Enemy* newEnemy = arena.Create<EnemyPanther>(pos, world);
 	enemies.push_back(newEnemy);
 }
 void EnemyManager::SpawnBat(Point pos)
 {
-	Enemy* newEnemy = new EnemyBat(pos);
+	MemScope scope(MemTag::ENTITIES);
+	Enemy* newEnemy = arena.Create<EnemyBat>(pos, world);
 	enemies.push_back(newEnemy);
 }
 void EnemyManager::SpawnTrader(Point pos)
 {
-	Enemy* newEnemy = new Trader(pos);
+	MemScope scope(MemTag::ENTITIES);
+	Enemy* newEnemy = arena.Create<Trader>(pos, world);
 	enemies.push_back(newEnemy);
 }
 void EnemyManager::SpawnBoss(Point pos)
 {
-	Enemy* newEnemy = new Boss(pos);
+	MemScope scope(MemTag::ENTITIES);
+	Enemy* newEnemy = arena.Create<Boss>(pos, world);
 	enemies.push_back(newEnemy);
 }
 bool EnemyManager::GetTraderPopUp()
@@ -68,6 +87,7 @@ bool EnemyManager::GetTraderPopUp()
 			return enemies[i]->GetPopUp();
 		}
 	}
+	return false;
 }
 bool EnemyManager::DeleteTraderPopUp()
 {
@@ -76,16 +96,16 @@ bool EnemyManager::DeleteTraderPopUp()
 			return enemies[i]->DeletePopUp();
 		}
 	}
+	return false;
 }
 bool EnemyManager::GetKilled()
 {
 	for (int i = 0; i < enemies.size(); ++i) {
 		if (enemies[i]->isActive) {
 			return enemies[i]->IsKilled();
-			delete enemies[i];
-			enemies[i]->Update();
 		}
 	}
+	return false;
 }
 Vector2 EnemyManager::GetKilledPos()
 {
@@ -94,6 +114,7 @@ Vector2 EnemyManager::GetKilledPos()
 			return { (float)target->weapon->HitboxOnAttack().pos.x, (float)target->weapon->HitboxOnAttack().pos.y };
 		}
 	}
+	return { 0, 0 };
 }
 bool EnemyManager::IsBossDead()
 {
@@ -107,6 +128,7 @@ bool EnemyManager::IsBossDead()
 			}
 		}
 	}
+	return false;
 }
 int EnemyManager::GetBossLife()
 {
@@ -115,6 +137,7 @@ int EnemyManager::GetBossLife()
 			return enemies[i]->GetLife();
 		}
 	}
+	return 0;
 }
 void EnemyManager::Render()
 {
@@ -124,6 +147,12 @@ void EnemyManager::Render()
 		}
 	}
 }
+void EnemyManager::StorePreviousPositions()
+{
+	for (int i = 0; i < enemies.size(); ++i) {
+		enemies[i]->StorePreviousPos();
+	}
+}
 void EnemyManager::RenderDebug()
 {
 	for (int i = 0; i < enemies.size(); ++i) {
@@ -132,15 +161,98 @@ void EnemyManager::RenderDebug()
 		}
 	}
 }
+void EnemyManager::RegisterColliders(SpatialHash& hash) const
+{
+	for (int i = 0; i < enemies.size(); ++i) {
+		if (enemies[i]->isActive) {
+			hash.Insert(i, enemies[i]->GetHitbox(), ColliderLayer::ENEMY);
+		}
+	}
+}
+void EnemyManager::UpdateProximity(SpatialHash& hash)
+{
+	for (int i = 0; i < enemies.size(); ++i) {
+		enemies[i]->nearTarget = false;
+	}
+
+	nearby.clear();
+	AABB box = target->GetHitbox();
+	box.pos.x -= ENEMY_PROXIMITY_MARGIN;
+	box.pos.y -= ENEMY_PROXIMITY_MARGIN;
+	box.width += 2 * ENEMY_PROXIMITY_MARGIN;
+	box.height += 2 * ENEMY_PROXIMITY_MARGIN;
+	hash.Query(box, ColliderLayer::ENEMY, nearby);
+
+	//The weapon hitbox only exists during the attack frame
+	if (target->weapon->GetFrame() == 2) {
+		box = target->weapon->HitboxOnAttack();
+		box.pos.x -= ENEMY_PROXIMITY_MARGIN;
+		box.pos.y -= ENEMY_PROXIMITY_MARGIN;
+		box.width += 2 * ENEMY_PROXIMITY_MARGIN;
+		box.height += 2 * ENEMY_PROXIMITY_MARGIN;
+		hash.Query(box, ColliderLayer::ENEMY, nearby);
+	}
+
+	for (int id : nearby) {
+		enemies[id]->nearTarget = true;
+	}
+}
 void EnemyManager::DestroyEnemies()
 {
 	for (size_t i = 0; i < enemies.size(); i++)
 	{
-		delete enemies[i];
+		enemies[i]->~Enemy();
 	}
 	enemies.clear();
+	arena.Reset();
+}
+void EnemyManager::CheckRoomMemory() const
+{
+#if defined(_DEBUG)
+	for (size_t i = 0; i < enemies.size(); i++)
+	{
+		if (!arena.IsLive(enemies[i]))
+		{
+			LOG("Internal error, enemy %d points into the memory of a previous room", (int)i);
+		}
+	}
+#endif
 }
 EnemyManager::~EnemyManager()
 {
 	DestroyEnemies();
 }
+void EnemyManager::SaveEnemies(BinaryWriter& out) const
+{
+	out.Write((int)enemies.size());
+	for (const Enemy* enemy : enemies) {
+		out.WriteEnum(enemy->GetType());
+		enemy->SaveState(out);
+	}
+}
+AppStatus EnemyManager::LoadEnemies(BinaryReader& in)
+{
+	DestroyEnemies();
+
+	int count = 0;
+	in.Read(count);
+	for (int i = 0; i < count && in.IsOk(); ++i) {
+		EnemyType type = EnemyType::ZOMBIE;
+		in.ReadEnum(type);
+
+		//The position is restored with the rest of the state
+		switch (type) {
+		case EnemyType::ZOMBIE:		SpawnZombie({ 0,0 });	break;
+		case EnemyType::PANTHER:	SpawnPanther({ 0,0 });	break;
+		case EnemyType::BAT:		SpawnBat({ 0,0 });		break;
+		case EnemyType::TRADER:		SpawnTrader({ 0,0 });	break;
+		case EnemyType::BOSS:		SpawnBoss({ 0,0 });		break;
+		default:
+			LOG("Snapshot contains an invalid enemy type %d", (int)type);
+			return AppStatus::ERROR;
+		}
+		if (map != nullptr) enemies.back()->SetTileMap(map);
+		enemies.back()->LoadState(in);
+	}
+	return in.IsOk() ? AppStatus::OK : AppStatus::ERROR;
+}
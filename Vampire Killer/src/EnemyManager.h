@@ -4,17 +4,26 @@
 #include "Enemy.h"
 #include <unordered_map>
 #include "raylib.h"
+#include "SpatialHash.h"
+#include "RoomArena.h"
 #include <vector>
 using namespace std;
 
+class World;
+
+//Extra pixels around the player and weapon hitboxes when flagging nearby enemies,
+//covers what an enemy can move before its next Brain() call
+#define ENEMY_PROXIMITY_MARGIN	24
+
+//Enemies updated by each job
+#define ENEMY_UPDATE_GRAIN		16
+
 class EnemyManager : public Entity
 {
 public:
-    static EnemyManager& Instance()
-    {
-        static EnemyManager instance; //Guaranteed to be initialized only once
-        return instance;
-    }
+    EnemyManager(World* world);
+    ~EnemyManager();
+
     void Update() override;
 
     void Reset();
@@ -38,18 +47,32 @@ public:
 
     void Render();
     void RenderDebug();
+    //Start of the tick for the drawing interpolation
+    void StorePreviousPositions();
 
+    //Destroy the enemies and release their memory at once, called when the room changes
     void DestroyEnemies();
+    //Debug builds check that every enemy was created in the current room, an enemy kept from
+    //a previous one would point into released memory
+    void CheckRoomMemory() const;
+
+    //Register the active enemies in the broadphase, the id is the enemy index
+    void RegisterColliders(SpatialHash& hash) const;
+    //Flag the enemies the player or the weapon may touch during the next update
+    void UpdateProximity(SpatialHash& hash);
+
+    //Snapshot of every enemy, restoring replaces the current enemies
+    void SaveEnemies(BinaryWriter& out) const;
+    AppStatus LoadEnemies(BinaryReader& in);
 
     Player* target;
 private:
 
-    //Private constructor to prevent instantiation
-    EnemyManager();
-    //Destructor
-    ~EnemyManager();
-
+    World* world;
+    //Enemies live until the room changes, they are created in the room arena
+    RoomArena arena;
     vector<Enemy*> enemies;
+    vector<int> nearby;
     TileMap* map;
 
 };
\ No newline at end of file
@@ -1,8 +1,8 @@
 
 #include "EnemyPanther.h"
-#include "EnemyManager.h"
+#include "World.h"
 
-EnemyPanther::EnemyPanther(Point pos) : Enemy(pos, PANTHER_HITBOX_HEIGHT, PANTHER_HITBOX_WIDTH, PANTHER_SPRITE_HEIGHT, PANTHER_SPRITE_WIDTH)
+EnemyPanther::EnemyPanther(Point pos, World* world) : Enemy(pos, PANTHER_HITBOX_HEIGHT, PANTHER_HITBOX_WIDTH, PANTHER_SPRITE_HEIGHT, PANTHER_SPRITE_WIDTH, world)
 {
 	state = EnemyState::ADVANCING;
 	look = EnemyLook::RIGHT;
@@ -15,6 +15,7 @@ EnemyPanther::EnemyPanther(Point pos) : Enemy(pos, PANTHER_HITBOX_HEIGHT, PANTHE
 }
 EnemyPanther::~EnemyPanther()
 {
+	Release();
 }
 AppStatus EnemyPanther::Initialise()
 {
@@ -55,13 +56,13 @@ AppStatus EnemyPanther::Initialise()
 	sprite->SetAnimationDelay((int)EnemyAnim::EMPTY, ANIM_DELAY);
 	sprite->AddKeyFrame((int)EnemyAnim::EMPTY, { 0, 0, 0, 0 });
 
-	if (EnemyManager::Instance().target->GetPos().x < 208 && EnemyManager::Instance().target->IsLookingRight()) {
+	if (world->enemies.target->GetPos().x < 208 && world->enemies.target->IsLookingRight()) {
 		SetPos({ 255, pos.y });
 		state = EnemyState::ADVANCING;
 		look = EnemyLook::LEFT;
 		SetAnimation((int)EnemyAnim::ADVANCING_LEFT);
 	}
-	else if (EnemyManager::Instance().target->GetPos().x > 68 && EnemyManager::Instance().target->IsLookingLeft()) {
+	else if (world->enemies.target->GetPos().x > 68 && world->enemies.target->IsLookingLeft()) {
 		SetPos({ 20, pos.y });
 		state = EnemyState::ADVANCING;
 		look = EnemyLook::RIGHT;
@@ -78,17 +79,12 @@ void EnemyPanther::Update()
 	Brain();
 	Sprite* sprite = dynamic_cast<Sprite*>(render);
 	sprite->Update();
+	if (!IsOnScreen()) isActive = false;
 }
 void EnemyPanther::Render()
 {
-	if (pos.x > 16 && pos.x < 256)
-	{
-		Point p = GetRenderingPosition();
-		render->Draw(p.x, p.y);
-	}
-	else {
-		isActive = false;
-	}
+	Point p = GetRenderingPosition();
+	render->Draw(p.x, p.y);
 }
 void EnemyPanther::Reset()
 {
@@ -96,7 +92,9 @@ void EnemyPanther::Reset()
 void EnemyPanther::Brain()
 {
 	MoveX();
-	if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->GetHitbox())) {
+	if (!nearTarget) return;
+
+	if (this->GetHitbox().TestAABB(world->enemies.target->GetHitbox())) {
 		DamagePlayer();
 	}
 }
@@ -128,11 +126,11 @@ void EnemyPanther::MoveX()
 	}
 	else if (state == EnemyState::ADVANCING) {
 		if (look == EnemyLook::RIGHT) {
-			pos.x += PANTHER_SPEED;
+			pos.x += StepX(PANTHER_SPEED);
 		}
 		else {
 
-			pos.x -= PANTHER_SPEED;
+			pos.x += StepX(-PANTHER_SPEED);
 		}
 	}
 	else if (state == EnemyState::DEAD) {
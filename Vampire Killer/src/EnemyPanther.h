@@ -1,7 +1,8 @@
 #pragma once
 #include "Enemy.h"
 
-#define PANTHER_SPEED	2
+//Running speed in pixels per second
+#define PANTHER_SPEED	120
 
 #define PANTHER_SPRITE_HEIGHT	32
 #define PANTHER_SPRITE_WIDTH	32
@@ -14,7 +15,7 @@
 class EnemyPanther : public Enemy
 {
 public:
-	EnemyPanther(Point pos);
+	EnemyPanther(Point pos, World* world);
 	virtual ~EnemyPanther();
 
 	AppStatus Initialise();
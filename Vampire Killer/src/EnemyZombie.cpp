@@ -1,8 +1,8 @@
 
 #include "EnemyZombie.h"
-#include "EnemyManager.h"
+#include "World.h"
 
-EnemyZombie::EnemyZombie(Point pos) : Enemy(pos, ZOMBIE_HITBOX_HEIGHT, ZOMBIE_HITBOX_WIDTH, ZOMBIE_SPRITE_HEIGHT, ZOMBIE_SPRITE_WIDTH)
+EnemyZombie::EnemyZombie(Point pos, World* world) : Enemy(pos, ZOMBIE_HITBOX_HEIGHT, ZOMBIE_HITBOX_WIDTH, ZOMBIE_SPRITE_HEIGHT, ZOMBIE_SPRITE_WIDTH, world)
 {
 	state = EnemyState::ADVANCING;
 	look = EnemyLook::LEFT;
@@ -56,13 +56,13 @@ AppStatus EnemyZombie::Initialise()
 	sprite->SetAnimationDelay((int)EnemyAnim::IDLE_RIGHT, ANIM_DELAY);
 	sprite->AddKeyFrame((int)EnemyAnim::IDLE_RIGHT, { 0, 0, -n, n });
 
-	if (EnemyManager::Instance().target->GetPos().x < 208 && EnemyManager::Instance().target->IsLookingRight()) {
+	if (world->enemies.target->GetPos().x < 208 && world->enemies.target->IsLookingRight()) {
 		SetPos({ 255, pos.y });
 		state = EnemyState::ADVANCING;
 		look = EnemyLook::LEFT;
 		SetAnimation((int)EnemyAnim::ADVANCING_LEFT);
 	}
-	else if (EnemyManager::Instance().target->GetPos().x > 68 && EnemyManager::Instance().target->IsLookingLeft()) {
+	else if (world->enemies.target->GetPos().x > 68 && world->enemies.target->IsLookingLeft()) {
 		SetPos({ 20, pos.y });
 		state = EnemyState::ADVANCING;
 		look = EnemyLook::RIGHT;
@@ -71,7 +71,7 @@ AppStatus EnemyZombie::Initialise()
 	else {
 		isActive = false;
 	}
-	if (EnemyManager::Instance().target->GetPos().y < 130 && EnemyManager::Instance().target->IsLookingRight()) {
+	if (world->enemies.target->GetPos().y < 130 && world->enemies.target->IsLookingRight()) {
 		SetPos({ pos.x, 79 });
 	}
 
@@ -81,25 +81,20 @@ void EnemyZombie::Update()
 {
 	if (killed) {
 		isActive = false;
-		EnemyManager::Instance().target->IncrScore(100);
+		Emit(EventType::ENEMY_KILLED, 100);
 	}
 	else {
 		Brain();
 		Sprite* sprite = dynamic_cast<Sprite*>(render);
 		sprite->Update();
+		if (!IsOnScreen()) isActive = false;
 	}
 }
 void EnemyZombie::Render()
 {
-	if (pos.x > 16 && pos.x < 256)
-	{
+	if (!killed) {
 		Point p = GetRenderingPosition();
-		if (!killed) {
-			render->Draw(p.x, p.y);
-		}
-	}
-	else {
-		isActive = false;
+		render->Draw(p.x, p.y);
 	}
 }
 void EnemyZombie::Reset()
@@ -109,19 +104,21 @@ void EnemyZombie::Brain()
 {
 	MoveX();
 	MoveY();
-	if (EnemyManager::Instance().target->GetState() == State::JUMPING || EnemyManager::Instance().target->GetState() == State::FALLING) {
-		AABB PlayerHitbox = EnemyManager::Instance().target->GetHitbox();
-		PlayerHitbox.pos.y = EnemyManager::Instance().target->GetHitbox().pos.y-16;
+	if (!nearTarget) return;
+
+	if (world->enemies.target->GetState() == State::JUMPING || world->enemies.target->GetState() == State::FALLING) {
+		AABB PlayerHitbox = world->enemies.target->GetHitbox();
+		PlayerHitbox.pos.y = world->enemies.target->GetHitbox().pos.y-16;
 		if(this->GetHitbox().TestAABB(PlayerHitbox)) {
 			DamagePlayer();
 		}
 	}
-	else if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->GetHitbox())) {
+	else if (this->GetHitbox().TestAABB(world->enemies.target->GetHitbox())) {
 		DamagePlayer();
 	}
-	if (EnemyManager::Instance().target->weapon->GetFrame() == 2) {
-		if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->weapon->HitboxOnAttack())) {
-			AudioPlayer::Instance().PlaySoundByName("Attack");
+	if (world->enemies.target->weapon->GetFrame() == 2) {
+		if (this->GetHitbox().TestAABB(world->enemies.target->weapon->HitboxOnAttack())) {
+			Emit(EventType::ENEMY_HIT, 0);
 			killed = true;
 		}
 	}
@@ -154,30 +151,31 @@ void EnemyZombie::MoveX()
 	}
 	else if(state == EnemyState::ADVANCING){
 		if (look == EnemyLook::RIGHT) {
-			pos.x += ZOMBIE_SPEED;
+			pos.x += StepX(ZOMBIE_SPEED);
 		}
 		else {
 
-			pos.x -= ZOMBIE_SPEED;
+			pos.x += StepX(-ZOMBIE_SPEED);
 		}
 	}
 	else if (state == EnemyState::DEAD) {
 		isActive = false;
 	}
 	else if (state == EnemyState::FALLING) {
-		pos.y += ZOMBIE_SPEED;
+		pos.y += StepY(ZOMBIE_SPEED);
 	}
 
 }
 void EnemyZombie::MoveY()
 {
-	pos.y += ZOMBIE_SPEED;
+	int probe = ProbeDown(ZOMBIE_SPEED);
 	if (map->TestCollisionGround(GetHitbox(), &pos.y) || map->TestCollisionEnemies(GetHitbox()))
 	{
 		if (state == EnemyState::FALLING) Stop();
 	}
 	else
 	{
+		pos.y -= probe;
 		if (state != EnemyState::FALLING) StartFalling();
 	}
 }
@@ -1,7 +1,8 @@
 #pragma once
 #include "Enemy.h"
 
-#define ZOMBIE_SPEED	1
+//Walking and falling speed in pixels per second
+#define ZOMBIE_SPEED	60
 
 #define ZOMBIE_SPRITE_HEIGHT	32
 #define ZOMBIE_SPRITE_WIDTH		32
@@ -14,7 +15,7 @@
 class EnemyZombie : public Enemy
 {
 public:
-	EnemyZombie(Point pos);
+	EnemyZombie(Point pos, World* world);
 	virtual ~EnemyZombie();
 
 	AppStatus Initialise();
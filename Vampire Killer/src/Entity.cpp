@@ -2,14 +2,21 @@
 #include "Entity.h"
 #include <cmath>
 #include "Globals.h"
+#include "FixedMath.h"
+#include "Sprite.h"
+#include "Snapshot.h"
+#include "MemTracker.h"
+#include <new>
 
-Entity::Entity()
+float Entity::interpolation = 1.0f;
+
+Entity::Entity() : pos({ 0,0 }), dir({ 0,0 }), prevPos({ 0,0 }), carry({ 0,0 }), width(0), height(0), frame_width(0), frame_height(0), render(nullptr)
 {
 }
-Entity::Entity(const Point& p, int w, int h) : pos(p), dir({ 0,0 }), width(w), height(h), frame_width(w), frame_height(h), render(nullptr)
+Entity::Entity(const Point& p, int w, int h) : pos(p), dir({ 0,0 }), prevPos(p), carry({ 0,0 }), width(w), height(h), frame_width(w), frame_height(h), render(nullptr)
 {
 }
-Entity::Entity(const Point& p, int w, int h, int frame_w, int frame_h) : pos(p), dir({ 0,0 }), width(w), height(h), frame_width(frame_w), frame_height(frame_h), render(nullptr)
+Entity::Entity(const Point& p, int w, int h, int frame_w, int frame_h) : pos(p), dir({ 0,0 }), prevPos(p), carry({ 0,0 }), width(w), height(h), frame_width(frame_w), frame_height(frame_h), render(nullptr)
 {
 }
 Entity::~Entity()
@@ -20,6 +27,16 @@ Entity::~Entity()
 		render = nullptr;
 	}
 }
+void* Entity::operator new(size_t size)
+{
+	void* ptr = MemTracker::Allocate(size, MemTag::ENTITIES);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+void Entity::operator delete(void* ptr)
+{
+	MemTracker::Free(ptr);
+}
 void Entity::SetPos(const Point& p)
 {
 	pos = p;
@@ -38,11 +55,43 @@ Point Entity::GetPos() const
 {
 	return pos;
 }
+void Entity::StorePreviousPos()
+{
+	prevPos = pos;
+}
+void Entity::SetInterpolation(float alpha)
+{
+	interpolation = alpha;
+}
+int Entity::StepX(int speed)
+{
+	return FixedStep(speed, carry.x);
+}
+int Entity::StepY(int speed)
+{
+	return FixedStep(speed, carry.y);
+}
+int Entity::ProbeDown(int speed)
+{
+	int step = StepY(speed);
+	int probe = step > 0 ? 0 : 1;
+	pos.y += step + probe;
+	return probe;
+}
 Point Entity::GetRenderingPosition() const
 {
+	//Jumps longer than a tile are teleports (room changes, respawns) and are drawn at once
+	Point draw = pos;
+	Point delta = pos - prevPos;
+	if (abs(delta.x) <= TILE_SIZE && abs(delta.y) <= TILE_SIZE)
+	{
+		draw.x = prevPos.x + (int)roundf(delta.x * interpolation);
+		draw.y = prevPos.y + (int)roundf(delta.y * interpolation);
+	}
+
 	Point p;
-	p.x = pos.x + width / 2 - frame_width / 2;
-	p.y = pos.y - (frame_height-1);
+	p.x = draw.x + width / 2 - frame_width / 2;
+	p.y = draw.y - (frame_height-1);
 	return p;
 }
 void Entity::Draw() const
@@ -77,3 +126,32 @@ void Entity::DrawHitbox(int x, int y, int w, int h, const Color& col) const
 	render->DrawBox(x, y-(h-1), w, h, c);
 	render->DrawCorners(x, y-(h-1), w, h);
 }
+void Entity::SaveState(BinaryWriter& out) const
+{
+	out.Write(pos.x);
+	out.Write(pos.y);
+	out.Write(dir.x);
+	out.Write(dir.y);
+	out.Write(carry.x);
+	out.Write(carry.y);
+	out.Write(width);
+	out.Write(height);
+
+	//Static images have no state
+	const Sprite* sprite = dynamic_cast<const Sprite*>(render);
+	if (sprite != nullptr) sprite->SaveState(out);
+}
+void Entity::LoadState(BinaryReader& in)
+{
+	in.Read(pos.x);
+	in.Read(pos.y);
+	in.Read(dir.x);
+	in.Read(dir.y);
+	in.Read(carry.x);
+	in.Read(carry.y);
+	in.Read(width);
+	in.Read(height);
+
+	Sprite* sprite = dynamic_cast<Sprite*>(render);
+	if (sprite != nullptr) sprite->LoadState(in);
+}
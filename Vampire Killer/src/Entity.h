@@ -6,6 +6,9 @@
 #include "RenderComponent.h"
 #include "AABB.h"
 
+class BinaryWriter;
+class BinaryReader;
+
 class Entity
 {
 public:
@@ -14,12 +17,21 @@ public:
 	Entity(const Point& p, int width, int height, int frame_width, int frame_height);
 	virtual ~Entity();
 
+	//Entities are charged to MemTag::ENTITIES wherever they are created
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr);
+
 	void SetPos(const Point& p);
 	virtual void Update();
 	AABB GetHitbox() const;
 	Point GetPos() const;
 	void SetHitbox(const Point& p, int w, int h);
 
+	//Keep the position at the start of the tick, drawing interpolates from it to the current one
+	void StorePreviousPos();
+	//Fraction of the next tick already elapsed when the frame is rendered, from 0 to 1
+	static void SetInterpolation(float alpha);
+
 	//Draw representation model
 	void Draw() const;
 	void DrawTint(const Color& col) const;
@@ -28,15 +40,32 @@ public:
 	void DrawHitbox(const Color& col) const;
 	void DrawHitbox(int x, int y, int w, int h, const Color& col) const;
 
+	//Snapshot of the position, the hitbox and the animation of the render component
+	virtual void SaveState(BinaryWriter& out) const;
+	virtual void LoadState(BinaryReader& in);
+
 protected:
 	Point GetRenderingPosition() const;
 
+	//Whole pixels to move this tick on each axis at 'speed' pixels per second, negative going left
+	//or up. Moves both ways on an axis share its carry, so they cancel out as the pixels would
+	int StepX(int speed);
+	int StepY(int speed);
+	//Moves down at 'speed' pixels per second before testing the ground below. Returns the pixel
+	//added on the ticks that don't move a whole one, taken back when there is no ground
+	int ProbeDown(int speed);
+
 	//Logical/physical model
 	Point pos, dir;
+	Point prevPos;
+	//Fractions of a pixel not moved yet, see FixedStep()
+	Point carry;
 	int width, height;				
 
 	//Representation model
 	int frame_width, frame_height;
 
 	RenderComponent *render;
+
+	static float interpolation;
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "EventBus.h"
+#include <stdio.h>
+
+EventBus::EventBus()
+{
+	frame = 0;
+	recording = false;
+}
+EventBus::~EventBus()
+{
+}
+void EventBus::Push(EventType type, const Point& pos, int value)
+{
+	GameEvent ev;
+	ev.type = type;
+	ev.pos = pos;
+	ev.value = value;
+	ev.item = ObjectType::CHAIN;
+	ev.enemy = (EnemyType)0;
+	Push(ev);
+}
+void EventBus::PushItem(EventType type, const Point& pos, ObjectType item, int value)
+{
+	GameEvent ev;
+	ev.type = type;
+	ev.pos = pos;
+	ev.value = value;
+	ev.item = item;
+	ev.enemy = (EnemyType)0;
+	Push(ev);
+}
+void EventBus::PushEnemy(EventType type, const Point& pos, EnemyType enemy, int value)
+{
+	GameEvent ev;
+	ev.type = type;
+	ev.pos = pos;
+	ev.value = value;
+	ev.item = ObjectType::CHAIN;
+	ev.enemy = enemy;
+	Push(ev);
+}
+void EventBus::Push(const GameEvent& ev)
+{
+	events.push_back(ev);
+	events.back().frame = frame;
+	if (recording && history.size() < EVENT_HISTORY_SIZE)
+	{
+		history.push_back(events.back());
+	}
+}
+const std::vector<GameEvent>& EventBus::GetEvents() const
+{
+	return events;
+}
+void EventBus::EndFrame()
+{
+	events.clear();
+	frame++;
+}
+int EventBus::GetFrame() const
+{
+	return frame;
+}
+void EventBus::StartRecording()
+{
+	history.clear();
+	recording = true;
+}
+void EventBus::StopRecording()
+{
+	recording = false;
+}
+bool EventBus::IsRecording() const
+{
+	return recording;
+}
+AppStatus EventBus::SaveRecording(const char* path) const
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+	{
+		LOG("Failed to open event log %s", path);
+		return AppStatus::ERROR;
+	}
+	fprintf(file, "frame event x y value item enemy\n");
+	for (const GameEvent& ev : history)
+	{
+		fprintf(file, "%d %s %d %d %d %d %d\n", ev.frame, GetName(ev.type), ev.pos.x, ev.pos.y, ev.value, (int)ev.item, (int)ev.enemy);
+	}
+	fclose(file);
+	LOG("Saved %d events to %s", (int)history.size(), path);
+	return AppStatus::OK;
+}
+const char* EventBus::GetName(EventType type)
+{
+	switch (type)
+	{
+		case EventType::ENEMY_KILLED:	return "ENEMY_KILLED";
+		case EventType::ENEMY_HIT:		return "ENEMY_HIT";
+		case EventType::ITEM_COLLECTED:	return "ITEM_COLLECTED";
+		case EventType::CHEST_OPENED:	return "CHEST_OPENED";
+		case EventType::LOOT_RELEASED:	return "LOOT_RELEASED";
+		case EventType::WALL_BROKEN:	return "WALL_BROKEN";
+		case EventType::PLAYER_DAMAGED:	return "PLAYER_DAMAGED";
+		case EventType::ITEM_PURCHASED:	return "ITEM_PURCHASED";
+	}
+	return "UNKNOWN";
+}
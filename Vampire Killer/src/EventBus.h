@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include "Point.h"
+#include "Object.h"
+#include "Globals.h"
+
+//Defined in Enemy.h
+enum class EnemyType;
+
+//Max events kept while recording, the ones pushed once it is full are not recorded
+#define EVENT_HISTORY_SIZE	100000
+
+enum class EventType {
+    ENEMY_KILLED, ENEMY_HIT,
+    ITEM_COLLECTED, CHEST_OPENED, LOOT_RELEASED,
+    WALL_BROKEN,
+    PLAYER_DAMAGED,
+    ITEM_PURCHASED
+};
+
+struct GameEvent
+{
+    EventType type;
+    //Frame the event was pushed in, set by the bus
+    int frame;
+    Point pos;
+    //Score, damage, hearts or distance to the floor depending on the type
+    int value;
+    //Collected item, opened chest, released loot or purchased weapon
+    ObjectType item;
+    EnemyType enemy;
+};
+
+//Gameplay events appended by the detection code and drained once per frame by the scene
+//Not thread safe, code running in jobs buffers its events and pushes them afterwards
+class EventBus
+{
+public:
+    EventBus();
+    ~EventBus();
+
+    void Push(EventType type, const Point& pos, int value);
+    void PushItem(EventType type, const Point& pos, ObjectType item, int value);
+    void PushEnemy(EventType type, const Point& pos, EnemyType enemy, int value);
+    void Push(const GameEvent& ev);
+
+    //Events pushed during the current frame
+    const std::vector<GameEvent>& GetEvents() const;
+    //Discard the current events and advance the frame counter
+    void EndFrame();
+    int GetFrame() const;
+
+    //Keep a copy of every event so the session can be written to a file
+    void StartRecording();
+    void StopRecording();
+    bool IsRecording() const;
+    AppStatus SaveRecording(const char* path) const;
+
+    static const char* GetName(EventType type);
+
+private:
+    std::vector<GameEvent> events;
+    std::vector<GameEvent> history;
+    int frame;
+    bool recording;
+};
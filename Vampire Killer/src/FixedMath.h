@@ -0,0 +1,24 @@
+#pragma once
+#include "Globals.h"
+
+//Integer maths for the simulation, gives the same results with every compiler and CPU so
+//replays and state hashes match across builds
+
+//Fixed point values with 16 fractional bits
+#define FIXED_SHIFT		16
+#define FIXED_ONE		(1 << FIXED_SHIFT)
+
+//Angles are fractions of a turn in 16 bits, they wrap around on overflow
+#define ANGLE_TURN		65536
+
+//Angle advanced each tick by something turning 'rad_per_s' radians per second
+#define ANGLE_STEP(rad_per_s)	((unsigned int)((rad_per_s) * ANGLE_TURN / (6.283185307179586 * SIM_TICKS_PER_SECOND) + 0.5))
+
+//Sine and cosine of an angle as fixed point values in [-FIXED_ONE, FIXED_ONE]
+int FixedSin(unsigned int angle);
+int FixedCos(unsigned int angle);
+
+//Whole units covered in a tick by something going 'per_second' units per second, either sign.
+//The fraction left is kept in 'carry' for the next tick so every tick rate covers the same
+//distance per second
+int FixedStep(int per_second, int& carry);
@@ -0,0 +1,58 @@
+#include "FrameArena.h"
+#include "MemTracker.h"
+
+FrameArena::FrameArena()
+{
+	memory.resize(FRAME_ARENA_SIZE);
+	used = 0;
+	peak = 0;
+	overflows = 0;
+	frame_start = MemTracker::GetThreadAllocations();
+	last_frame_allocations = 0;
+}
+FrameArena::~FrameArena()
+{
+}
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	size_t start = (used + alignment - 1) & ~(alignment - 1);
+	if (start + size > memory.size())
+	{
+		overflows++;
+		return ::operator new(size);
+	}
+	used = start + size;
+	if (used > peak) peak = used;
+	return &memory[start];
+}
+void FrameArena::Deallocate(void* ptr)
+{
+	if (ptr != nullptr && !Owns(ptr)) ::operator delete(ptr);
+}
+void FrameArena::Reset()
+{
+	used = 0;
+	last_frame_allocations = (int)(MemTracker::GetThreadAllocations() - frame_start);
+	frame_start = MemTracker::GetThreadAllocations();
+}
+bool FrameArena::Owns(const void* ptr) const
+{
+	const unsigned char* p = (const unsigned char*)ptr;
+	return p >= memory.data() && p < memory.data() + memory.size();
+}
+size_t FrameArena::GetUsed() const
+{
+	return used;
+}
+size_t FrameArena::GetPeak() const
+{
+	return peak;
+}
+int FrameArena::GetOverflows() const
+{
+	return overflows;
+}
+int FrameArena::GetLastFrameAllocations() const
+{
+	return last_frame_allocations;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+//Memory of each frame arena, enough for the temporaries of a busy frame
+#define FRAME_ARENA_SIZE	(256 * 1024)
+
+//Bump allocator for memory that only lives until the end of the frame. Allocating moves a
+//pointer forward and Reset(), called at the start of every update, frees everything at once.
+//Requests that don't fit are served by the heap and counted as overflows.
+//There is one arena per thread, bots run their simulations in parallel.
+class FrameArena
+{
+public:
+	static FrameArena& Instance()
+	{
+		static thread_local FrameArena instance; //One per thread, initialized on first use
+		return instance;
+	}
+
+	void* Allocate(size_t size, size_t alignment = alignof(max_align_t));
+	//Arena memory is only released by Reset(), overflows go back to the heap
+	void Deallocate(void* ptr);
+
+	//Start a new frame, nothing allocated in the previous one may be used after this
+	void Reset();
+
+	bool Owns(const void* ptr) const;
+
+	//Bytes used in the current frame and the most used by any frame
+	size_t GetUsed() const;
+	size_t GetPeak() const;
+	//Allocations that didn't fit in the arena since the program started
+	int GetOverflows() const;
+
+	//Heap allocations made by the calling thread between the last two Reset()
+	int GetLastFrameAllocations() const;
+
+private:
+	FrameArena();
+	~FrameArena();
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	std::vector<unsigned char> memory;
+	size_t used;
+	size_t peak;
+	int overflows;
+
+	unsigned long long frame_start;
+	int last_frame_allocations;
+};
+
+//STL allocator taking its memory from the frame arena of the thread, for containers that
+//are built and thrown away within a frame
+template<class T>
+struct FrameAllocator
+{
+	typedef T value_type;
+
+	FrameAllocator() = default;
+	template<class U>
+	FrameAllocator(const FrameAllocator<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		return (T*)FrameArena::Instance().Allocate(n * sizeof(T), alignof(T));
+	}
+	void deallocate(T* ptr, size_t)
+	{
+		FrameArena::Instance().Deallocate(ptr);
+	}
+};
+template<class T, class U>
+bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+template<class T, class U>
+bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+template<class T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -1,11 +1,15 @@
 #include "Game.h"
 #include "Globals.h"
 #include "ResourceManager.h"
+#include "JobSystem.h"
+#include "RenderQueue.h"
+#include "FrameArena.h"
 #include <stdio.h>
 
 Game::Game()
 {
     state = GameState::INTRO_UPC;
+    world = nullptr;
     scene = nullptr;
     img_menu = nullptr;
     img_menu_play = nullptr;
@@ -20,15 +24,34 @@ Game::Game()
     img_intro_simon = nullptr;
     img_intro_gui = nullptr;
 
-    timerWin = 1800;
-    timerLose = 300;
-    timerPlay = 120;
-    timerIntroduction = 360;
+    timerTransition = 0;
+    preloading = false;
+
+    timerWin = GAME_WIN_TIME;
+    timerLose = GAME_OVER_TIME;
+    timerPlay = MENU_PLAY_TIME;
+    timerIntroduction = INTRODUCTION_TIME;
 
     panAnimation = 200;
 
     playerAnim = 240;
 
+    accumulator = 0.0;
+    frameRate = SIM_TICKS_PER_SECOND;
+    sceneUpdated = false;
+    skipRender = false;
+    skippedFrames = 0;
+    previousTicks = 0;
+
+    idleMode = true;
+    dirty = true;
+    idle = false;
+    idleTicks = 0;
+    staticWallStart = 0.0;
+    staticCpuStart = 0;
+    staticFrames = 0;
+    staticRedraws = 0;
+
     target = {};
     src = {};
     dst = {};
@@ -48,13 +71,15 @@ AppStatus Game::Initialise(float scale)
     w = WINDOW_WIDTH * scale;
     h = WINDOW_HEIGHT * scale;
 
-    SetConfigFlags(FLAG_FULLSCREEN_MODE);
+    SetConfigFlags(FLAG_FULLSCREEN_MODE | FLAG_VSYNC_HINT);
 
     //Initialise window
     InitWindow((int)w, (int)h, "Vampire killer");
 
     InitAudioDevice();
 
+    world = new World(true);
+
     //Render texture initialisation, used to hold the rendering result so we can easily resize it
     target = LoadRenderTexture(WINDOW_WIDTH, WINDOW_HEIGHT);
     if (target.id == 0)
@@ -66,6 +91,13 @@ AppStatus Game::Initialise(float scale)
     src = { 0, 0, WINDOW_WIDTH, -WINDOW_HEIGHT };
     dst = { 0, 0, w, h };
 
+    //Worker threads for the updates and the asset loading
+    if (JobSystem::Instance().Initialise() != AppStatus::OK)
+    {
+        LOG("Failed to start the job system");
+        return AppStatus::ERROR;
+    }
+
     //Load resources
     if (LoadResources() != AppStatus::OK)
     {
@@ -73,19 +105,23 @@ AppStatus Game::Initialise(float scale)
         return AppStatus::ERROR;
     }
 
-    //Set the target frame rate for the application
-    SetTargetFPS(60);
+    //Render at the refresh rate of the display, the game logic runs at SIM_TICKS_PER_SECOND
+    int refresh_rate = GetMonitorRefreshRate(GetCurrentMonitor());
+    if (refresh_rate > 0) frameRate = refresh_rate;
+    SetTargetFPS(frameRate);
+    staticWallStart = GetTime();
+    staticCpuStart = clock();
     SetMasterVolume(0.6);
 
     //Disable the escape key to quit functionality
     SetExitKey(0);
 
-    AudioPlayer::Instance().CreateMusic("audio/Music/15 Unused.ogg", "Unused");
-    AudioPlayer::Instance().SetMusicLoopStatus("Unused", false);
-    AudioPlayer::Instance().CreateMusic("audio/Music/10 Game Over.ogg", "GameOver");
-    AudioPlayer::Instance().SetMusicLoopStatus("GameOver", false);
-    AudioPlayer::Instance().CreateMusic("audio/Music/01 Prologue.ogg", "Prologue");
-    AudioPlayer::Instance().SetMusicLoopStatus("Prologue", false);
+    world->audio.CreateMusic("audio/Music/15 Unused.ogg", "Unused", ResourceOwner::GAME);
+    world->audio.SetMusicLoopStatus("Unused", false);
+    world->audio.CreateMusic("audio/Music/10 Game Over.ogg", "GameOver", ResourceOwner::GAME);
+    world->audio.SetMusicLoopStatus("GameOver", false);
+    world->audio.CreateMusic("audio/Music/01 Prologue.ogg", "Prologue", ResourceOwner::GAME);
+    world->audio.SetMusicLoopStatus("Prologue", false);
 
 
     return AppStatus::OK;
@@ -94,69 +130,41 @@ AppStatus Game::LoadResources()
 {
     ResourceManager& data = ResourceManager::Instance();
     
-    if (data.LoadTexture(Resource::IMG_MENU, "images/Spritesheets/Introduction/Intro Space.png") != AppStatus::OK)
+    const TextureRequest requests[] = {
+        { Resource::IMG_MENU, "images/Spritesheets/Introduction/Intro Space.png" },
+        { Resource::IMG_MENU_PLAY, "images/Spritesheets/Introduction/IntroPlay.png" },
+        { Resource::IMG_MENU_EMPTY, "images/Spritesheets/Introduction/Intro Empty.png" },
+        { Resource::IMG_INTRO_UPC, "images/Spritesheets/Introduction/IntroUPC.png" },
+        { Resource::IMG_INTRO_BACKGROUND, "images/Spritesheets/Introduction/IntroBackground.png" },
+        { Resource::IMG_GAME_WIN, "images/Spritesheets/Introduction/GameWin.png" },
+        { Resource::IMG_INTRODUCTION, "images/Spritesheets/Introduction/IntroOutside.png" },
+        { Resource::IMG_INTRO_BAT, "images/Spritesheets/Introduction/IntroBat.png" },
+        { Resource::IMG_INTRO_CLOUD, "images/Spritesheets/Introduction/IntroCloud.png" },
+        { Resource::IMG_PLAYER, "images/Spritesheets/Simon/Simon Spritesheet.png" },
+        { Resource::IMG_HUD_INTRO, "images/Spritesheets/Introduction/IntroHud.png" }
+    };
+    if (data.LoadTextures(requests, sizeof(requests) / sizeof(requests[0])) != AppStatus::OK)
     {
         return AppStatus::ERROR;
     }
     img_menu = data.GetTexture(Resource::IMG_MENU);
-    if (data.LoadTexture(Resource::IMG_MENU_PLAY, "images/Spritesheets/Introduction/IntroPlay.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_menu_play = data.GetTexture(Resource::IMG_MENU_PLAY);
-    if (data.LoadTexture(Resource::IMG_MENU_EMPTY, "images/Spritesheets/Introduction/Intro Empty.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_menu_empty = data.GetTexture(Resource::IMG_MENU_EMPTY);
-    if (data.LoadTexture(Resource::IMG_INTRO_UPC, "images/Spritesheets/Introduction/IntroUPC.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_intro_upc = data.GetTexture(Resource::IMG_INTRO_UPC);
-    if (data.LoadTexture(Resource::IMG_INTRO_BACKGROUND, "images/Spritesheets/Introduction/IntroBackground.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_intro_background = data.GetTexture(Resource::IMG_INTRO_BACKGROUND);
-    if (data.LoadTexture(Resource::IMG_GAME_WIN, "images/Spritesheets/Introduction/GameWin.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_game_win = data.GetTexture(Resource::IMG_GAME_WIN);
 
-
-    if (data.LoadTexture(Resource::IMG_INTRODUCTION, "images/Spritesheets/Introduction/IntroOutside.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_introduction = data.GetTexture(Resource::IMG_INTRODUCTION);
-    if (data.LoadTexture(Resource::IMG_INTRO_BAT, "images/Spritesheets/Introduction/IntroBat.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_intro_bat = data.GetTexture(Resource::IMG_INTRO_BAT);
-    if (data.LoadTexture(Resource::IMG_INTRO_CLOUD, "images/Spritesheets/Introduction/IntroCloud.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_intro_cloud = data.GetTexture(Resource::IMG_INTRO_CLOUD);
-    if (data.LoadTexture(Resource::IMG_PLAYER, "images/Spritesheets/Simon/Simon Spritesheet.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_intro_simon = data.GetTexture(Resource::IMG_PLAYER);
-    if (data.LoadTexture(Resource::IMG_HUD_INTRO, "images/Spritesheets/Introduction/IntroHud.png") != AppStatus::OK)
-    {
-        return AppStatus::ERROR;
-    }
     img_intro_gui = data.GetTexture(Resource::IMG_HUD_INTRO);
     
     return AppStatus::OK;
 }
 AppStatus Game::BeginPlay()
 {
-    scene = new Scene();
+    scene = new Scene(world);
     if (scene == nullptr)
     {
         LOG("Failed to allocate memory for Scene");
@@ -181,111 +189,234 @@ AppStatus Game::Update()
     //Check if user attempts to close the window, either by clicking the close button or by pressing Alt+F4
     if(WindowShouldClose()) return AppStatus::QUIT;
 
-    AudioPlayer::Instance().Update();
+    //Temporaries of the previous frame are released at once
+    FrameArena::Instance().Reset();
 
     if (IsKeyPressed(KEY_F)) {
         ToggleFullscreen();  // modifies window size when scaling!
+        dirty = true;
     }
 
+    //Run as many fixed ticks as the time elapsed since the last frame, the rest is carried over
+    world->input.LatchKeys();
+    if (world->input.HasKeys() || IsWindowResized()) dirty = true;
+    GameState previous = state;
+    accumulator += GetFrameTime();
+    int ticks = 0;
+    bool capped = false;
+    while (accumulator >= SIM_TICK_TIME)
+    {
+        if (ticks == GAME_MAX_TICKS_PER_FRAME)
+        {
+            //Too far behind, drop the time left so the game slows down instead of spiralling
+            accumulator = 0.0;
+            capped = true;
+            break;
+        }
+        AppStatus status = Tick();
+        world->input.ClearKeys();
+        accumulator -= SIM_TICK_TIME;
+        ticks++;
+        if (status != AppStatus::OK) return status;
+    }
+    //A scene that stopped updating (ending fade, game over) is drawn at its last tick, otherwise
+    //the entities would move back and forth between their last two positions
+    Entity::SetInterpolation(sceneUpdated ? (float)(accumulator / SIM_TICK_TIME) : 1.0f);
+
+    //Displays slower than the tick rate run several ticks every frame without being behind, and a
+    //frame after a short one (vsync jitter) catches up the missing tick, neither is skipped
+    int frame_ticks = (SIM_TICKS_PER_SECOND + frameRate - 1) / frameRate;
+    bool behind = capped || (ticks > frame_ticks && previousTicks >= frame_ticks);
+    skipRender = behind && !IsStaticState() && skippedFrames < GAME_MAX_FRAME_SKIP;
+    skippedFrames = skipRender ? skippedFrames + 1 : 0;
+    previousTicks = ticks;
+
+    if (state != previous)
+    {
+        //Only static screens count frames, leaving any other state just restarts the count
+        ReportStaticScreen();
+        dirty = true;
+    }
+    if (!IsStaticState() || !idleMode) dirty = true;
+
+    //Static screen without changes, lower the frame rate until something happens
+    if (dirty)
+    {
+        idleTicks = 0;
+        SetIdle(false);
+    }
+    else
+    {
+        idleTicks += ticks;
+        if (idleTicks >= IDLE_DELAY) SetIdle(true);
+    }
+    return AppStatus::OK;
+}
+void Game::SetIdleMode(bool enabled)
+{
+    idleMode = enabled;
+}
+bool Game::IsStaticState() const
+{
+    return state == GameState::INTRO_UPC || state == GameState::TRANSITION_1 || state == GameState::INTRO_BACKGROUND ||
+           state == GameState::TRANSITION_2 || state == GameState::MAIN_MENU;
+}
+void Game::SetIdle(bool value)
+{
+    if (idle == value) return;
+    idle = value;
+    SetTargetFPS(idle ? IDLE_FPS : frameRate);
+}
+void Game::ReportStaticScreen()
+{
+    double wall = GetTime() - staticWallStart;
+    double cpu = (double)(clock() - staticCpuStart) / CLOCKS_PER_SEC;
+    if (wall > 1.0 && staticFrames > 0)
+    {
+        LOG("Static screen %.1f s: %d frames, %d redraws, %.1f%% of a core (%.2f ms per frame)", wall, staticFrames,
+            staticRedraws, 100.0 * cpu / wall, 1000.0 * cpu / staticFrames);
+    }
+    staticWallStart = GetTime();
+    staticCpuStart = clock();
+    staticFrames = 0;
+    staticRedraws = 0;
+}
+AppStatus Game::Tick()
+{
+    //Textures of the next state decoded in the background are created once they are ready
+    if (preloading && ResourceManager::Instance().FinishPreload()) preloading = false;
+
+    sceneUpdated = false;
     switch (state)
     {
         case GameState::INTRO_UPC:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            if (IsKeyPressed(KEY_SPACE))
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (world->input.WasKeyPressed(KEY_SPACE))
             {
                 state = GameState::TRANSITION_1;
+                timerTransition = TRANSITION_TIME;
+
+                //Load the gameplay textures while the intro screens are shown
+                Scene::PreloadTextures();
+                preloading = true;
             }
-            if (IsKeyPressed(KEY_ZERO))
+            if (world->input.WasKeyPressed(KEY_ZERO))
             {
                 if (BeginPlay() != AppStatus::OK) return AppStatus::ERROR;
                 state = GameState::PLAYING;
             }
             break;
         case GameState::TRANSITION_1:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            WaitTime(0.5);
-            state = GameState::INTRO_BACKGROUND;
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (--timerTransition <= 0)
+            {
+                state = GameState::INTRO_BACKGROUND;
+                timerTransition = INTRO_BACKGROUND_TIME;
+            }
             break;
         case GameState::INTRO_BACKGROUND:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            WaitTime(2);
-            state = GameState::TRANSITION_2;
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (--timerTransition <= 0)
+            {
+                state = GameState::TRANSITION_2;
+                timerTransition = TRANSITION_TIME;
+            }
             break;
         case GameState::TRANSITION_2:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            WaitTime(0.5);
-            state = GameState::MAIN_MENU;
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (--timerTransition <= 0)
+            {
+                state = GameState::MAIN_MENU;
+            }
             break;
         case GameState::MAIN_MENU: 
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            if (IsKeyPressed(KEY_SPACE))
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (world->input.WasKeyPressed(KEY_SPACE))
             {
                     state = GameState::MENU_PLAY;
             }
             break;
         case GameState::MENU_PLAY:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            AudioPlayer::Instance().PlayMusicByName("Prologue");
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            world->audio.PlayMusicByName("Prologue");
             timerPlay--;
             if (timerPlay == 0) {
-                timerPlay = 120;
+                timerPlay = MENU_PLAY_TIME;
                 state = GameState::INTRODUCTION;
             }
             break;
         case GameState::INTRODUCTION:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
             timerIntroduction--;
             if (timerIntroduction == 0) {
-                AudioPlayer::Instance().StopMusicByName("Prologue");
+                world->audio.StopMusicByName("Prologue");
                 if (BeginPlay() != AppStatus::OK) return AppStatus::ERROR;
                 state = GameState::PLAYING;
-                timerIntroduction = 300;
+                timerIntroduction = INTRODUCTION_REPLAY_TIME;
                 panAnimation = 200;
                 playerAnim = 240;
             }
+            else {
+                //Cloud, bats and Simon move across the introduction screen
+                if (timerIntroduction % TIME_TO_PERIOD(0.2) == 0) panAnimation--;
+                if (timerIntroduction % TIME_TO_PERIOD(0.033) == 0) playerAnim--;
+            }
+            break;
+        case GameState::TRANSITION_WIN:
+            if (--timerTransition <= 0)
+            {
+                FinishPlay();
+                state = GameState::GAME_WIN;
+            }
             break;
         case GameState::GAME_WIN:
-            if (IsKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
-            if (AudioPlayer::Instance().IsMusicPlaying("Prologue")) AudioPlayer::Instance().StopMusicByName("Prologue");
-            AudioPlayer::Instance().PlayMusicByName("Unused");
+            if (world->input.WasKeyPressed(KEY_ESCAPE)) return AppStatus::QUIT;
+            if (world->audio.IsMusicPlaying("Prologue")) world->audio.StopMusicByName("Prologue");
+            world->audio.PlayMusicByName("Unused");
             timerWin--;
             if (timerWin == 0) {
-                AudioPlayer::Instance().StopMusicByName("Unused");
+                world->audio.StopMusicByName("Unused");
                 state = GameState::MAIN_MENU;
                 panAnimation = 200;
-                timerWin = 1800;
+                timerWin = GAME_WIN_TIME;
+            }
+            else if (timerWin % TIME_TO_PERIOD(0.067) == 0) {
+                //Credits scroll up
+                panAnimation--;
             }
             break;
 
         case GameState::PLAYING:  
-            if (IsKeyPressed(KEY_ESCAPE))
+            if (world->input.WasKeyPressed(KEY_ESCAPE))
             {
                 FinishPlay();
-                AudioPlayer::Instance().StopMusicByName("VampireKiller");
+                world->audio.StopMusicByName("VampireKiller");
                 state = GameState::MAIN_MENU;
             }
             else if (scene->PlayerIsDead())
             {
-                AudioPlayer::Instance().StopMusicByName("VampireKiller");
-                AudioPlayer::Instance().PlayMusicByName("GameOver");
+                world->audio.StopMusicByName("VampireKiller");
+                world->audio.PlayMusicByName("GameOver");
                 timerLose--;
                 if (timerLose == 0) {
                     FinishPlay();
-                    AudioPlayer::Instance().StopMusicByName("GameOver");
+                    world->audio.StopMusicByName("GameOver");
                     state = GameState::MAIN_MENU;
-                    timerLose = 300;
+                    timerLose = GAME_OVER_TIME;
                 }
             }
             else if (scene->PlayerHasWon())
             {
-                FinishPlay();
-                WaitTime(1);
-                state = GameState::GAME_WIN;
+                //The last frame fades out before the ending
+                state = GameState::TRANSITION_WIN;
+                timerTransition = WIN_TRANSITION_TIME;
             }
             else
             {
                 //Game logic
+                world->input.Poll();
                 scene->Update();
+                sceneUpdated = true;
             }
             break;
     }
@@ -293,6 +424,23 @@ AppStatus Game::Update()
 }
 void Game::Render()
 {
+    if (IsStaticState()) staticFrames++;
+
+    //Nothing changed or the game is catching up, present the last image again
+    if (!dirty || skipRender)
+    {
+        BeginDrawing();
+        DrawTexturePro(target.texture, src, dst, { 0, 0 }, 0.0f, WHITE);
+        EndDrawing();
+        return;
+    }
+    dirty = false;
+    if (IsStaticState()) staticRedraws++;
+
+    RenderQueue::Instance().BeginFrame();
+    //Texture modes can't be nested, the HUD texture is updated before drawing the frame
+    if (state == GameState::PLAYING || state == GameState::TRANSITION_WIN) scene->PrepareHud();
+
     //Draw everything in the render texture, note this will not be rendered on screen, yet
     BeginTextureMode(target);
     ClearBackground({6,6,6,255});
@@ -314,50 +462,43 @@ void Game::Render()
 
         case GameState::MENU_PLAY:
             DrawTexture(*img_menu_play, 0, 0, WHITE);
-            if (timerPlay % 6 == 0 || timerPlay % 6 == 1 || timerPlay % 6 == 2) {
+            if (timerPlay % TIME_TO_PERIOD(0.1) < TIME_TO_TICKS(0.05)) {
                 DrawTexture(*img_menu_empty, 0, 0, WHITE);
             }
             break;
 
         case GameState::INTRODUCTION:
             DrawTexture(*img_introduction, 0, 0, WHITE);
-            if (timerIntroduction % 12 == 0) {
-                panAnimation--;
-            }
             DrawTexture(*img_intro_cloud, panAnimation, 72, WHITE);
 
-            if (timerIntroduction % 6 == 0 || timerIntroduction % 6 == 1 || timerIntroduction % 6 == 2) {
+            if (timerIntroduction % TIME_TO_PERIOD(0.1) < TIME_TO_TICKS(0.05)) {
                 DrawTextureRec(*img_intro_bat, { 0,0,16,16 }, { (float)panAnimation - 80, 60 }, WHITE);
             }
             else {
                 DrawTextureRec(*img_intro_bat, { 16,16,16,16 }, { (float)panAnimation - 80, 60 }, WHITE);
             }
             
-            if (timerIntroduction % 6 == 0 || timerIntroduction % 6 == 1 || timerIntroduction % 6 == 2) {
+            if (timerIntroduction % TIME_TO_PERIOD(0.1) < TIME_TO_TICKS(0.05)) {
                 DrawTextureRec(*img_intro_bat, { 0,0,16,16 }, { -(float)panAnimation + 250, (float)panAnimation - 92}, WHITE);
             }
             else {
                 DrawTextureRec(*img_intro_bat, { 16,16,16,16 }, { -(float)panAnimation + 250, (float)panAnimation - 92 }, WHITE);
             }
 
-            if (timerIntroduction % 2 == 0) {
-                playerAnim--;
-            }
-
-            if (timerIntroduction < 121) {
+            if (timerIntroduction <= TIME_TO_TICKS(2.0)) {
                 DrawTextureRec(*img_intro_simon, { 0,32 * 7,-32,32 }, { 124, 175 }, WHITE);
             }
             else {
-                if (timerIntroduction % 30 < 8) {
+                if (timerIntroduction % TIME_TO_PERIOD(0.5) < TIME_TO_TICKS(0.133)) {
                     DrawTextureRec(*img_intro_simon, { 0,0,-32,32 }, { (float)playerAnim, 175 }, WHITE);
                 }
-                else if (timerIntroduction % 30 < 16) {
+                else if (timerIntroduction % TIME_TO_PERIOD(0.5) < TIME_TO_TICKS(0.267)) {
                     DrawTextureRec(*img_intro_simon, { 32*1,0,-32,32 }, { (float)playerAnim, 175 }, WHITE);
                 }
-                else if (timerIntroduction % 30 < 23) {
+                else if (timerIntroduction % TIME_TO_PERIOD(0.5) < TIME_TO_TICKS(0.383)) {
                     DrawTextureRec(*img_intro_simon, { 32*2,0,-32,32 }, { (float)playerAnim, 175 }, WHITE);
                 }
-                else if (timerIntroduction % 30 < 30) {
+                else {
                     DrawTextureRec(*img_intro_simon, { 32*3,0,-32,32 }, { (float)playerAnim, 175 }, WHITE);
                 }
             }
@@ -368,15 +509,17 @@ void Game::Render()
             break;
 
         case GameState::GAME_WIN:
-            if (timerWin % 4 == 0) {
-                panAnimation--;
-            }
             DrawTexture(*img_game_win, 0, panAnimation, WHITE);
             break;
 
         case GameState::PLAYING:
             scene->Render();
             break;
+
+        case GameState::TRANSITION_WIN:
+            scene->Render();
+            DrawRectangle(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, Fade(BLACK, 1.0f - (float)timerTransition / WIN_TRANSITION_TIME));
+            break;
     }
     
     EndTextureMode();
@@ -388,7 +531,19 @@ void Game::Render()
 }
 void Game::Cleanup()
 {
+    ReportStaticScreen();
     UnloadResources();
+    ResourceManager::Instance().ReleasePreloaded();
+    if (scene != nullptr)
+    {
+        scene->Release();
+        delete scene;
+        scene = nullptr;
+    }
+    //Sounds and music are unloaded with the world, before closing the audio device
+    delete world;
+    world = nullptr;
+    JobSystem::Instance().Shutdown();
     CloseAudioDevice();
     CloseWindow();
 }
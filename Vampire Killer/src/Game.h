@@ -1,6 +1,33 @@
 #pragma once
 #include "Globals.h"
 #include "Scene.h"
+#include <time.h>
+
+//Durations of the black screens between the intro screens, the intro background and the fade out when winning
+#define TRANSITION_TIME				TIME_TO_TICKS(0.5)
+#define INTRO_BACKGROUND_TIME		TIME_TO_TICKS(2.0)
+#define WIN_TRANSITION_TIME			TIME_TO_TICKS(1.0)
+
+//Durations of the menu, introduction and ending screens
+#define MENU_PLAY_TIME				TIME_TO_TICKS(2.0)
+#define INTRODUCTION_TIME			TIME_TO_TICKS(6.0)
+#define INTRODUCTION_REPLAY_TIME	TIME_TO_TICKS(5.0)
+#define GAME_OVER_TIME				TIME_TO_TICKS(5.0)
+#define GAME_WIN_TIME				TIME_TO_TICKS(30.0)
+
+//Static screens unchanged for this long drop to the idle frame rate until something changes
+//The idle rate must leave time for the timers: GAME_MAX_TICKS_PER_FRAME ticks per frame at most
+#define IDLE_DELAY					TIME_TO_TICKS(0.5)
+#define IDLE_FPS					15
+
+//The game logic advances in fixed ticks of SIM_TICK_TIME whatever the display refresh rate
+//Ticks run in a single frame at most, a machine that can't keep up slows the game down
+//instead of falling further behind every frame
+#define GAME_MAX_TICKS_PER_FRAME	TIME_TO_PERIOD(0.083)
+
+//Frames that had to run more ticks than a frame of the display lasts to catch up present the
+//previous image instead of drawing the scene again, at most this many frames in a row
+#define GAME_MAX_FRAME_SKIP			2
 
 enum class GameState {
     INTRO_UPC, TRANSITION_1,
@@ -9,6 +36,7 @@ enum class GameState {
     MAIN_MENU,
     MENU_PLAY,
     PLAYING, 
+    TRANSITION_WIN,
     GAME_WIN };
 
 class Game
@@ -18,11 +46,20 @@ public:
     ~Game();
 
     AppStatus Initialise(float scale);
+    //Redraw every frame at full rate even on static screens, used to measure the idle mode
+    void SetIdleMode(bool enabled);
+    //Advance the game by the time elapsed since the last frame in fixed ticks
     AppStatus Update();
     void Render();
     void Cleanup();
 
 private:
+    AppStatus Tick();
+    //Screens that show the same image until the state changes
+    bool IsStaticState() const;
+    void SetIdle(bool idle);
+    //Log the CPU time used by the static screen shown since the last call
+    void ReportStaticScreen();
     AppStatus BeginPlay();
     void FinishPlay();
 
@@ -30,6 +67,7 @@ private:
     void UnloadResources();
 
     GameState state;
+    World *world;
     Scene *scene;
     const Texture2D *img_menu;
     const Texture2D* img_menu_play;
@@ -44,6 +82,10 @@ private:
     const Texture2D* img_intro_gui;
     const Texture2D* img_intro_simon;
 
+    //Ticks left in the timed states (transitions and intro background)
+    int timerTransition;
+    bool preloading;
+
     int timerWin;
     int timerLose;
     int timerPlay;
@@ -52,6 +94,31 @@ private:
     int panAnimation;
 
     float playerAnim;
+
+    //Elapsed time not simulated yet, less than a tick after each update
+    double accumulator;
+    int frameRate;
+
+    //Whether the last tick updated the scene, entities are only interpolated while it runs
+    bool sceneUpdated;
+
+    //Rendering doesn't change the game state, so a frame can skip it when the game is behind
+    bool skipRender;
+    int skippedFrames;
+    int previousTicks;
+
+    //The render texture is only drawn again when the image changed, otherwise the last
+    //one is presented. After IDLE_DELAY without changes the frame rate drops to IDLE_FPS.
+    bool idleMode;
+    bool dirty;
+    bool idle;
+    int idleTicks;
+
+    //Wall and CPU time when the current static screen was shown, and its frames
+    double staticWallStart;
+    clock_t staticCpuStart;
+    int staticFrames;
+    int staticRedraws;
     
 
     //To work with original game units and then scale the result
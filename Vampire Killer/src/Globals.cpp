@@ -2,9 +2,14 @@
 #include <fstream>
 #include <iostream>
 #include <ctime>
+#include <mutex>
 
 void log(const char file[], int line, const char* text, ...)
 {
+    //Jobs can log from worker threads, the buffers below are shared
+    static std::mutex log_lock;
+    std::lock_guard<std::mutex> guard(log_lock);
+
     static char tmp_string[256];
     static char tmp_string2[256];
     static va_list ap;
@@ -26,7 +26,18 @@ void log(const char file[], int line, const char* text, ...);
 //Game constants
 #define TILE_SIZE		16
 #define LEVEL_WIDTH		18
-#define LEVEL_HEIGHT	11
+//The castle rooms stand on row 11 and the stairs down leave through row 12
+#define LEVEL_HEIGHT	13
+
+//Simulation clock, the game logic advances in fixed ticks at this rate
+//Durations are given in seconds and converted with TIME_TO_TICKS, speeds in pixels per second
+//moved with FixedStep(), so a different rate keeps the timers, the animations and the movement
+//as they are
+#define SIM_TICKS_PER_SECOND	60
+#define SIM_TICK_TIME			(1.0 / SIM_TICKS_PER_SECOND)
+#define TIME_TO_TICKS(seconds)	((int)((seconds) * SIM_TICKS_PER_SECOND + 0.5))
+//Periods used as a modulus or counted down to zero, short ones would round to no ticks at all
+#define TIME_TO_PERIOD(seconds)	(TIME_TO_TICKS(seconds) > 0 ? TIME_TO_TICKS(seconds) : 1)
 
 //Entities animation delay
-#define ANIM_DELAY		8
\ No newline at end of file
+#define ANIM_DELAY		TIME_TO_PERIOD(0.133)
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "Input.h"
+#include <raylib.h>
+
+Input::Input()
+{
+	current = 0;
+	previous = 0;
+	key_count = 0;
+}
+Input::~Input()
+{
+}
+void Input::Poll()
+{
+	unsigned int buttons = 0;
+	if (IsKeyDown(KEY_LEFT))	buttons |= BUTTON_MASK(Button::LEFT);
+	if (IsKeyDown(KEY_RIGHT))	buttons |= BUTTON_MASK(Button::RIGHT);
+	if (IsKeyDown(KEY_UP))		buttons |= BUTTON_MASK(Button::UP);
+	if (IsKeyDown(KEY_DOWN))	buttons |= BUTTON_MASK(Button::DOWN);
+	if (IsKeyDown(KEY_SPACE))	buttons |= BUTTON_MASK(Button::WHIP);
+	if (IsKeyDown(KEY_Z))		buttons |= BUTTON_MASK(Button::THROW);
+	if (IsKeyDown(KEY_R))		buttons |= BUTTON_MASK(Button::REWIND);
+	Set(buttons);
+}
+void Input::Set(unsigned int buttons)
+{
+	previous = current;
+	current = buttons;
+}
+void Input::Reset()
+{
+	current = 0;
+	previous = 0;
+	key_count = 0;
+}
+bool Input::IsDown(Button b) const
+{
+	return (current & BUTTON_MASK(b)) != 0;
+}
+bool Input::IsPressed(Button b) const
+{
+	return (current & ~previous & BUTTON_MASK(b)) != 0;
+}
+bool Input::IsReleased(Button b) const
+{
+	return (previous & ~current & BUTTON_MASK(b)) != 0;
+}
+unsigned int Input::GetButtons() const
+{
+	return current;
+}
+void Input::LatchKeys()
+{
+	for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed())
+	{
+		if (key_count < INPUT_MAX_KEYS && !WasKeyPressed(key)) keys[key_count++] = key;
+	}
+}
+bool Input::WasKeyPressed(int key) const
+{
+	for (int i = 0; i < key_count; ++i)
+	{
+		if (keys[i] == key) return true;
+	}
+	return false;
+}
+bool Input::HasKeys() const
+{
+	return key_count > 0;
+}
+void Input::ClearKeys()
+{
+	key_count = 0;
+}
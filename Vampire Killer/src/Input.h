@@ -0,0 +1,45 @@
+#pragma once
+
+//Buttons read by the gameplay, each one is a bit of the input mask. Rewind steps back while held in debug mode
+enum class Button { LEFT, RIGHT, UP, DOWN, WHIP, THROW, REWIND };
+
+#define BUTTON_MASK(b)	(1u << (unsigned int)(b))
+
+//Keys pressed in a frame that are kept for the next tick, raylib queues as many per frame
+#define INPUT_MAX_KEYS	16
+
+//Buttons held during the current and the previous tick. The game fills it from the keyboard,
+//simulations without a window set the mask directly, so the gameplay never reads raylib keys.
+class Input
+{
+public:
+    Input();
+    ~Input();
+
+    //Read the keyboard, must be called once per frame before updating the scene
+    void Poll();
+    //Set the buttons held this tick, the previous mask is kept to detect presses and releases
+    void Set(unsigned int buttons);
+    void Reset();
+
+    bool IsDown(Button b) const;
+    bool IsPressed(Button b) const;
+    bool IsReleased(Button b) const;
+
+    unsigned int GetButtons() const;
+
+    //Queue the keys pressed during the frame, must be called once per rendered frame. The menu
+    //and debug keys are read by the ticks with WasKeyPressed() until ClearKeys(), so a press in a
+    //frame that runs no tick is not lost and a frame running several ticks sees it only once.
+    void LatchKeys();
+    bool WasKeyPressed(int key) const;
+    bool HasKeys() const;
+    void ClearKeys();
+
+private:
+    unsigned int current;
+    unsigned int previous;
+
+    int keys[INPUT_MAX_KEYS];
+    int key_count;
+};
@@ -0,0 +1,185 @@
+#include "JobSystem.h"
+
+JobSystem::JobSystem()
+{
+	queued = 0;
+	running = false;
+	next_worker = 0;
+}
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+AppStatus JobSystem::Initialise(int count)
+{
+	if (running) return AppStatus::OK;
+
+	if (count <= 0)
+	{
+		count = (int)std::thread::hardware_concurrency() - 1;
+	}
+	if (count > JOB_MAX_WORKERS) count = JOB_MAX_WORKERS;
+	if (count < 0) count = 0;
+
+	running = true;
+	for (int i = 0; i < count; ++i)
+	{
+		workers.push_back(new Worker());
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+	}
+	LOG("Job system started with %d workers", count);
+	return AppStatus::OK;
+}
+void JobSystem::Shutdown()
+{
+	if (!running) return;
+
+	{
+		std::lock_guard<std::mutex> guard(sleep_lock);
+		running = false;
+	}
+	wake.notify_all();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	threads.clear();
+
+	for (Worker* worker : workers)
+	{
+		delete worker;
+	}
+	workers.clear();
+}
+int JobSystem::GetWorkerCount() const
+{
+	return (int)workers.size();
+}
+void JobSystem::Submit(const std::function<void()>& job, JobCounter& counter)
+{
+	counter.pending++;
+	if (workers.empty())
+	{
+		//No workers, run it right away
+		Job j = { job, &counter };
+		Run(j);
+		return;
+	}
+
+	//Jobs are spread round-robin, idle workers steal the rest
+	Worker* worker = workers[next_worker++ % workers.size()];
+	{
+		std::lock_guard<std::mutex> guard(worker->lock);
+		worker->jobs.push_back({ job, &counter });
+	}
+	{
+		std::lock_guard<std::mutex> guard(sleep_lock);
+		queued++;
+	}
+	wake.notify_one();
+}
+void JobSystem::Wait(JobCounter& counter)
+{
+	Job job;
+	while (counter.pending > 0)
+	{
+		//Help the workers with the jobs of this group instead of blocking
+		if (TryGetJob(counter, job)) Run(job);
+		else std::this_thread::yield();
+	}
+}
+void JobSystem::ParallelFor(int count, int grain, const std::function<void(int, int)>& body)
+{
+	if (count <= 0) return;
+	if (grain < 1) grain = 1;
+
+	if (count <= grain || workers.empty())
+	{
+		body(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (int begin = 0; begin < count; begin += grain)
+	{
+		int end = begin + grain < count ? begin + grain : count;
+		Submit([&body, begin, end]() { body(begin, end); }, counter);
+	}
+	Wait(counter);
+}
+void JobSystem::WorkerLoop(int index)
+{
+	Job job;
+	while (true)
+	{
+		if (TryGetJob(index, job))
+		{
+			Run(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(sleep_lock);
+		wake.wait(guard, [this]() { return queued > 0 || !running; });
+		if (!running && queued == 0) return;
+	}
+}
+bool JobSystem::TryGetJob(int index, Job& job)
+{
+	int count = (int)workers.size();
+	if (count == 0) return false;
+
+	//Own deque first, newest job
+	{
+		Worker* own = workers[index];
+		std::lock_guard<std::mutex> guard(own->lock);
+		if (!own->jobs.empty())
+		{
+			job = own->jobs.back();
+			own->jobs.pop_back();
+			queued--;
+			return true;
+		}
+	}
+
+	//Steal the oldest job of another worker
+	int start = index + 1;
+	for (int i = 0; i < count; ++i)
+	{
+		Worker* victim = workers[(start + i) % count];
+		std::lock_guard<std::mutex> guard(victim->lock);
+		if (!victim->jobs.empty())
+		{
+			job = victim->jobs.front();
+			victim->jobs.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+bool JobSystem::TryGetJob(const JobCounter& counter, Job& job)
+{
+	for (Worker* worker : workers)
+	{
+		std::lock_guard<std::mutex> guard(worker->lock);
+		for (auto it = worker->jobs.begin(); it != worker->jobs.end(); ++it)
+		{
+			if (it->counter == &counter)
+			{
+				job = *it;
+				worker->jobs.erase(it);
+				queued--;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+void JobSystem::Run(Job& job)
+{
+	job.func();
+	job.counter->pending--;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <functional>
+#include "Globals.h"
+
+//Upper limit of worker threads, the main thread also runs jobs while it waits
+#define JOB_MAX_WORKERS		15
+
+//Counts the jobs of a group that are still pending
+struct JobCounter
+{
+    std::atomic<int> pending{ 0 };
+};
+
+//Scheduler with one job deque per worker. A worker pops its own jobs from the back and,
+//when it runs out, steals from the front of the other deques.
+class JobSystem
+{
+public:
+    static JobSystem& Instance()
+    {
+        static JobSystem instance; //Guaranteed to be initialized only once
+        return instance;
+    }
+
+    //Start the workers, 0 uses one worker per hardware thread minus the main thread
+    AppStatus Initialise(int workers = 0);
+    void Shutdown();
+
+    int GetWorkerCount() const;
+
+    //Queue a job, 'counter' is decremented when it finishes
+    void Submit(const std::function<void()>& job, JobCounter& counter);
+    //Run queued jobs of the counter until every one of them has finished. Jobs of other groups
+    //are left to the workers, so a job waiting inside another one never runs a third one nested
+    void Wait(JobCounter& counter);
+
+    //Call body(begin, end) over [0, count) in chunks of 'grain' items
+    //Runs on the calling thread when there is a single chunk or no worker
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& body);
+
+private:
+    //Private constructor to prevent instantiation
+    JobSystem();
+    //Destructor
+    ~JobSystem();
+
+    struct Job
+    {
+        std::function<void()> func;
+        JobCounter* counter;
+    };
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(int index);
+    //Pop from the worker's own deque or steal from another one
+    bool TryGetJob(int index, Job& job);
+    //Take any queued job of the counter, from whichever deque holds it
+    bool TryGetJob(const JobCounter& counter, Job& job);
+    void Run(Job& job);
+
+    std::vector<Worker*> workers;
+    std::vector<std::thread> threads;
+
+    //Sleeping workers wake up when jobs are queued
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::atomic<int> queued;
+    std::atomic<bool> running;
+    std::atomic<unsigned int> next_worker;
+};
@@ -0,0 +1,263 @@
+#include "MemTracker.h"
+#include "Globals.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <mutex>
+
+//Placed before every block, keeps the size and the tag for Free(). 16-byte aligned so the
+//memory returned is aligned like malloc's
+struct alignas(16) BlockHeader
+{
+	BlockHeader* prev;
+	BlockHeader* next;
+	//Start of the malloc block, over-aligned blocks leave a gap before the header
+	void* base;
+	size_t size;
+	MemTag tag;
+	//Allocation number, the leak report gives it to find the block again
+	unsigned int id;
+};
+
+struct TagCounters
+{
+	std::atomic<long long> live_bytes{ 0 };
+	std::atomic<long long> peak_bytes{ 0 };
+	std::atomic<long long> live_allocations{ 0 };
+	std::atomic<long long> allocations{ 0 };
+};
+
+//Constant initialised, they are ready before the first allocation of any static constructor
+static TagCounters counters[(int)MemTag::COUNT];
+static std::atomic<long long> total_live{ 0 };
+static std::atomic<long long> total_peak{ 0 };
+static std::atomic<unsigned int> next_id{ 0 };
+static std::atomic<bool> leak_report{ false };
+static thread_local MemTag current_tag = MemTag::OTHER;
+static thread_local unsigned long long thread_allocations = 0;
+
+#if defined(_DEBUG)
+//Live blocks, newest first
+static std::mutex block_lock;
+static BlockHeader* blocks = nullptr;
+#endif
+
+static const char* tag_names[(int)MemTag::COUNT] = { "OTHER", "TILEMAP", "ENTITIES", "SPRITES", "AUDIO", "RESOURCES" };
+
+static void RaisePeak(std::atomic<long long>& peak, long long value)
+{
+	long long current = peak.load(std::memory_order_relaxed);
+	while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+void* MemTracker::Allocate(size_t size, MemTag tag, size_t alignment)
+{
+	if (alignment < alignof(BlockHeader)) alignment = alignof(BlockHeader);
+
+	//malloc only guarantees the alignment of max_align_t, the rest is made up with padding
+	size_t padding = alignment > alignof(std::max_align_t) ? alignment - alignof(std::max_align_t) : 0;
+	unsigned char* base = (unsigned char*)malloc(sizeof(BlockHeader) + padding + size);
+	if (base == nullptr) return nullptr;
+	uintptr_t block = ((uintptr_t)(base + sizeof(BlockHeader)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	BlockHeader* header = (BlockHeader*)block - 1;
+	header->base = base;
+	header->size = size;
+	header->tag = tag;
+	header->id = next_id.fetch_add(1, std::memory_order_relaxed);
+
+	TagCounters& counter = counters[(int)tag];
+	long long live = counter.live_bytes.fetch_add((long long)size, std::memory_order_relaxed) + (long long)size;
+	RaisePeak(counter.peak_bytes, live);
+	counter.live_allocations.fetch_add(1, std::memory_order_relaxed);
+	counter.allocations.fetch_add(1, std::memory_order_relaxed);
+	RaisePeak(total_peak, total_live.fetch_add((long long)size, std::memory_order_relaxed) + (long long)size);
+	thread_allocations++;
+
+#if defined(_DEBUG)
+	std::lock_guard<std::mutex> guard(block_lock);
+	header->prev = nullptr;
+	header->next = blocks;
+	if (blocks != nullptr) blocks->prev = header;
+	blocks = header;
+#endif
+	return header + 1;
+}
+void MemTracker::Free(void* ptr)
+{
+	if (ptr == nullptr) return;
+	BlockHeader* header = (BlockHeader*)ptr - 1;
+
+	TagCounters& counter = counters[(int)header->tag];
+	counter.live_bytes.fetch_sub((long long)header->size, std::memory_order_relaxed);
+	counter.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+	total_live.fetch_sub((long long)header->size, std::memory_order_relaxed);
+
+#if defined(_DEBUG)
+	{
+		std::lock_guard<std::mutex> guard(block_lock);
+		if (header->prev != nullptr)	header->prev->next = header->next;
+		else							blocks = header->next;
+		if (header->next != nullptr) header->next->prev = header->prev;
+	}
+#endif
+	free(header->base);
+}
+MemTag MemTracker::GetTag()
+{
+	return current_tag;
+}
+void MemTracker::SetTag(MemTag tag)
+{
+	current_tag = tag;
+}
+const char* MemTracker::GetTagName(MemTag tag)
+{
+	return tag_names[(int)tag];
+}
+MemTagStats MemTracker::GetStats(MemTag tag)
+{
+	const TagCounters& counter = counters[(int)tag];
+	MemTagStats stats;
+	stats.live_bytes = counter.live_bytes.load(std::memory_order_relaxed);
+	stats.peak_bytes = counter.peak_bytes.load(std::memory_order_relaxed);
+	stats.live_allocations = counter.live_allocations.load(std::memory_order_relaxed);
+	stats.allocations = counter.allocations.load(std::memory_order_relaxed);
+	return stats;
+}
+MemTagStats MemTracker::GetTotal()
+{
+	MemTagStats total = {};
+	for (int i = 0; i < (int)MemTag::COUNT; ++i)
+	{
+		MemTagStats stats = GetStats((MemTag)i);
+		total.live_allocations += stats.live_allocations;
+		total.allocations += stats.allocations;
+	}
+	total.live_bytes = total_live.load(std::memory_order_relaxed);
+	total.peak_bytes = total_peak.load(std::memory_order_relaxed);
+	return total;
+}
+unsigned long long MemTracker::GetThreadAllocations()
+{
+	return thread_allocations;
+}
+void MemTracker::Report()
+{
+	for (int i = 0; i < (int)MemTag::COUNT; ++i)
+	{
+		MemTagStats stats = GetStats((MemTag)i);
+		LOG("Memory %s: %lld KB live in %lld blocks, %lld KB peak, %lld allocations", tag_names[i],
+			stats.live_bytes / 1024, stats.live_allocations, stats.peak_bytes / 1024, stats.allocations);
+	}
+	MemTagStats total = GetTotal();
+	LOG("Memory: %lld KB live, %lld KB peak, %lld allocations", total.live_bytes / 1024, total.peak_bytes / 1024, total.allocations);
+}
+void MemTracker::EnableLeakReport()
+{
+	leak_report = true;
+}
+
+//Registered before main starts, so it runs after the singletons created while running have
+//been destroyed
+struct LeakReport
+{
+	~LeakReport()
+	{
+		if (!leak_report) return;
+
+		//The report allocates nothing, the counters are read as they are now
+		FILE* files[2] = { fopen("log.txt", "a"), stderr };
+		for (FILE* file : files)
+		{
+			if (file == nullptr) continue;
+			MemTagStats total = MemTracker::GetTotal();
+			if (total.live_allocations == 0)
+			{
+				fprintf(file, "Memory: no leaks\n");
+				continue;
+			}
+			fprintf(file, "Memory: %lld blocks leaked, %lld bytes\n", total.live_allocations, total.live_bytes);
+			for (int i = 0; i < (int)MemTag::COUNT; ++i)
+			{
+				MemTagStats stats = MemTracker::GetStats((MemTag)i);
+				if (stats.live_allocations > 0)
+				{
+					fprintf(file, "Memory: %s leaked %lld blocks, %lld bytes\n", tag_names[i], stats.live_allocations, stats.live_bytes);
+				}
+			}
+#if defined(_DEBUG)
+			//The other threads have finished, the list is read without the lock
+			int listed = 0;
+			for (BlockHeader* block = blocks; block != nullptr && listed < 64; block = block->next, ++listed)
+			{
+				fprintf(file, "Memory: leaked block {%u} %s, %zu bytes\n", block->id, tag_names[(int)block->tag], block->size);
+			}
+#endif
+		}
+		if (files[0] != nullptr) fclose(files[0]);
+	}
+};
+static LeakReport leak_report_at_exit;
+
+MemScope::MemScope(MemTag tag)
+{
+	previous = MemTracker::GetTag();
+	MemTracker::SetTag(tag);
+}
+MemScope::~MemScope()
+{
+	MemTracker::SetTag(previous);
+}
+
+//Every heap allocation of the program is charged to the tag of the calling thread
+void* operator new(size_t size)
+{
+	void* ptr = MemTracker::Allocate(size, MemTracker::GetTag());
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return MemTracker::Allocate(size, MemTracker::GetTag());
+}
+void operator delete(void* ptr) noexcept
+{
+	MemTracker::Free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept
+{
+	MemTracker::Free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	MemTracker::Free(ptr);
+}
+
+//Over-aligned types, such as the cache line aligned counters of SpscRing inside World
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* ptr = MemTracker::Allocate(size, MemTracker::GetTag(), (size_t)alignment);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return MemTracker::Allocate(size, MemTracker::GetTag(), (size_t)alignment);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	MemTracker::Free(ptr);
+}
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+	MemTracker::Free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	MemTracker::Free(ptr);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stddef.h>
+
+//Subsystems the heap allocations are charged to. The tag of the calling thread is used, set
+//with a MemScope around the code of each subsystem; allocations outside any scope are OTHER.
+enum class MemTag { OTHER, TILEMAP, ENTITIES, SPRITES, AUDIO, RESOURCES, COUNT };
+
+struct MemTagStats
+{
+	long long live_bytes;
+	long long peak_bytes;
+	long long live_allocations;
+	//Allocations since the program started
+	long long allocations;
+};
+
+//Every call to the global operator new goes through the tracker, which keeps the live bytes and
+//the peak of each tag. Works with any compiler, unlike the MSVC debug heap it replaces.
+//Debug builds also keep the list of live blocks, the leak report at shutdown lists them.
+class MemTracker
+{
+public:
+	//Blocks are 16-byte aligned, larger powers of two can be asked for over-aligned types
+	static void* Allocate(size_t size, MemTag tag, size_t alignment = 16);
+	static void Free(void* ptr);
+
+	//Tag of the allocations of the calling thread
+	static MemTag GetTag();
+	static void SetTag(MemTag tag);
+	static const char* GetTagName(MemTag tag);
+
+	static MemTagStats GetStats(MemTag tag);
+	//Sum of every tag, the peak is the highest total reached
+	static MemTagStats GetTotal();
+
+	//Allocations made by the calling thread since it started
+	static unsigned long long GetThreadAllocations();
+
+	//Write the stats of every tag to the log
+	static void Report();
+
+	//Log the allocations still alive when the program ends, after every static object has
+	//been destroyed. Written straight to log.txt and stderr, LOG is gone by then.
+	static void EnableLeakReport();
+};
+
+//Charge the allocations of the current thread to 'tag' until the end of the scope
+class MemScope
+{
+public:
+	MemScope(MemTag tag);
+	~MemScope();
+
+private:
+	MemTag previous;
+};
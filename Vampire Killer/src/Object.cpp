@@ -1,6 +1,7 @@
 #include "Object.h"
 #include "StaticImage.h"
 #include "Sprite.h"
+#include "Snapshot.h"
 
 Object::Object(const Point& p, ObjectType t, Vector2 levelIndex) : Entity(p, OBJECT_PHYSICAL_SIZE, OBJECT_PHYSICAL_SIZE, OBJECT_FRAME_SIZE, OBJECT_FRAME_SIZE)
 {
@@ -79,6 +80,8 @@ Object::Object(const Point& p, ObjectType t, Vector2 levelIndex) : Entity(p, OBJ
     }
 
     levelContainer = levelIndex;
+    containedLoot = t;
+    floorDistance = 0;
 }
 Object::Object(const Point& p, ObjectType t, Vector2 levelIndex, ObjectType loot, int distanceToFloor) : Entity(p, OBJECT_PHYSICAL_SIZE, OBJECT_PHYSICAL_SIZE, OBJECT_FRAME_SIZE, OBJECT_FRAME_SIZE)
 {
@@ -166,7 +169,7 @@ Object::~Object()
         render->Release();
     }
     render2->Release();
-    delete[] render2;
+    delete render2;
 }
 void Object::Update()
 {
@@ -206,3 +209,13 @@ Vector2 Object::GetObjectLevel() const
 {
     return levelContainer;
 }
+void Object::SaveState(BinaryWriter& out) const
+{
+    Entity::SaveState(out);
+    dynamic_cast<const Sprite*>(render2)->SaveState(out);
+}
+void Object::LoadState(BinaryReader& in)
+{
+    Entity::LoadState(in);
+    dynamic_cast<Sprite*>(render2)->LoadState(in);
+}
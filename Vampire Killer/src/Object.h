@@ -34,6 +34,10 @@ public:
 
     Vector2 GetObjectLevel() const;
 
+    //Type, room and loot are given to the constructor, only the animation is saved here
+    void SaveState(BinaryWriter& out) const override;
+    void LoadState(BinaryReader& in) override;
+
 private:
     ObjectType type;
     ObjectType containedLoot;
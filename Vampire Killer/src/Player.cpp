@@ -5,13 +5,17 @@
 #include "Globals.h"
 #include "Weapon.h"
 #include <raymath.h>
+#include "World.h"
+#include "Snapshot.h"
+#include "FixedMath.h"
 
-Player::Player(const Point& p, State s, Look view) :
-	Entity(p, PLAYER_PHYSICAL_WIDTH, PLAYER_PHYSICAL_HEIGHT, PLAYER_FRAME_SIZE, PLAYER_FRAME_SIZE)
+Player::Player(const Point& p, State s, Look view, World* world) :
+	Entity(p, PLAYER_PHYSICAL_WIDTH, PLAYER_PHYSICAL_HEIGHT, PLAYER_FRAME_SIZE, PLAYER_FRAME_SIZE), world(world)
 {
 	state = s;
 	look = view;
-	jump_delay = PLAYER_JUMP_DELAY;
+	jump_carry = PLAYER_JUMP_CARRY;
+	ladder_carry = 0;
 	attack_delay = PLAYER_ATTACK_DELAY;
 	die_delay = PLAYER_DYING_DELAY;
 	damaged_delay = 0;
@@ -28,7 +32,8 @@ Player::Player(const Point& p, State s, Look view) :
 
 	shield = false;
 	doorKey = false;
-	shield = false;
+	chestKey = false;
+	hearts = 0;
 }
 Player::~Player()
 {
@@ -168,9 +173,9 @@ AppStatus Player::Initialise()
 
 	sprite->SetAnimation((int)PlayerAnim::IDLE_RIGHT);
 
-	AudioPlayer::Instance().CreateSound("audio/SFX/26.wav", "MissAttack");
+	world->audio.CreateSound("audio/SFX/26.wav", "MissAttack");
 
-	AudioPlayer::Instance().CreateSound("audio/SFX/04.wav", "PlayerDamaged");
+	world->audio.CreateSound("audio/SFX/04.wav", "PlayerDamaged");
 
 	return AppStatus::OK;
 }
@@ -253,11 +258,11 @@ void Player::DecrLife(int n)
 		if (life - n > 0) {
 			life -= n;
 			damaged_delay = PLAYER_DAMAGED_DELAY;
-			AudioPlayer::Instance().PlaySoundByName("PlayerDamaged");
+			world->audio.PlaySoundByName("PlayerDamaged");
 			StartDamaged();
 		}
 		else if (life - n <= 0){
-			AudioPlayer::Instance().PlaySoundByName("PlayerDamaged");
+			world->audio.PlaySoundByName("PlayerDamaged");
 			StartDying();
 		}
 	}
@@ -265,11 +270,11 @@ void Player::DecrLife(int n)
 		if (life - (n/2) > 0) {
 			life -= (n/2);
 			damaged_delay = PLAYER_DAMAGED_DELAY;
-			AudioPlayer::Instance().PlaySoundByName("PlayerDamaged");
+			world->audio.PlaySoundByName("PlayerDamaged");
 			StartDamaged();
 		}
 		else if (life - (n/2) <= 0) {
-			AudioPlayer::Instance().PlaySoundByName("PlayerDamaged");
+			world->audio.PlaySoundByName("PlayerDamaged");
 			StartDying();
 		}
 	}
@@ -332,6 +337,10 @@ void Player::SwitchChestKey()
 		chestKey = true;
 	}
 }
+void Player::SetChestKey(bool has)
+{
+	chestKey = has;
+}
 bool Player::HasDoorKey() const
 {
 	return doorKey;
@@ -345,6 +354,10 @@ void Player::SwitchDoorKey()
 		doorKey = true;
 	}
 }
+void Player::SetDoorKey(bool has)
+{
+	doorKey = has;
+}
 bool Player::HasShield() const
 {
 	return shield;
@@ -448,14 +461,14 @@ void Player::StartJumping()
 		state = State::JUMPING;
 		if (IsLookingRight())	SetAnimation((int)PlayerAnim::JUMPING_RIGHT);
 		else					SetAnimation((int)PlayerAnim::JUMPING_LEFT);
-		jump_delay = PLAYER_JUMP_DELAY;
+		jump_carry = PLAYER_JUMP_CARRY;
 	}
 	else {
 		dir.y = -PLAYER_JUMP_FORCE;
 		state = State::JUMPING;
 		if (IsLookingRight())	SetAnimation((int)PlayerAnim::JUMPING_RIGHT_SHIELD);
 		else					SetAnimation((int)PlayerAnim::JUMPING_LEFT_SHIELD);
-		jump_delay = PLAYER_JUMP_DELAY;
+		jump_carry = PLAYER_JUMP_CARRY;
 	}
 }
 void Player::StartWhip() {
@@ -699,9 +712,9 @@ void Player::MoveX()
 				}*/
 			}
 		}
-		else if (IsKeyDown(KEY_LEFT) && !IsKeyDown(KEY_RIGHT))
+		else if (world->input.IsDown(Button::LEFT) && !world->input.IsDown(Button::RIGHT))
 		{
-			pos.x += -PLAYER_SPEED;
+			pos.x += StepX(-PLAYER_SPEED);
 			if (state == State::IDLE) StartWalkingLeft();
 			else
 			{
@@ -715,9 +728,9 @@ void Player::MoveX()
 				if (state == State::WALKING) Stop();
 			}
 		}
-		else if (IsKeyDown(KEY_RIGHT) && !IsKeyDown(KEY_LEFT))
+		else if (world->input.IsDown(Button::RIGHT) && !world->input.IsDown(Button::LEFT))
 		{
-			pos.x += PLAYER_SPEED;
+			pos.x += StepX(PLAYER_SPEED);
 			if (state == State::IDLE) StartWalkingRight();
 			else
 			{
@@ -756,7 +769,7 @@ void Player::MoveY()
 		
 		else //idle, walking, falling
 		{
-			pos.y += PLAYER_SPEED;
+			int probe = ProbeDown(PLAYER_SPEED);
 			box = GetHitbox();
 
 			if (map->TestCollisionGround(box, &pos.y))
@@ -764,15 +777,15 @@ void Player::MoveY()
 				if (state == State::FALLING) Stop();
 
 				if (state != State::WHIP && state != State::THROWING) {
-					if (IsKeyDown(KEY_UP))
+					if (world->input.IsDown(Button::UP))
 					{
 						StartJumping();
 
-						if (map->TestCollisionStairs(box) && IsKeyPressed(KEY_UP))
+						if (map->TestCollisionStairs(box) && world->input.IsPressed(Button::UP))
 						{
 							StartClimbingUp();
 						}
-						else if (map->TestCollisionStairs(box) && IsKeyPressed(KEY_DOWN))
+						else if (map->TestCollisionStairs(box) && world->input.IsPressed(Button::DOWN))
 						{
 							StartClimbingDown();
 						}
@@ -781,6 +794,7 @@ void Player::MoveY()
 			}
 			else
 			{
+				pos.y -= probe;
 				if (state != State::WHIP && state != State::THROWING) {
 					if (state != State::FALLING) StartFalling();
 				}
@@ -812,115 +826,123 @@ void Player::Static()
 		LogicDamaged();
 	}
 	else {
-		pos.y += PLAYER_SPEED;
+		int probe = ProbeDown(PLAYER_SPEED);
 		box = GetHitbox();
-		if (IsKeyPressed(KEY_SPACE))
+		if (world->input.IsPressed(Button::WHIP))
 		{
 			StartWhip();
 		}
-		else if (IsKeyPressed(KEY_Z))
+		else if (world->input.IsPressed(Button::THROW))
 		{
 			StartThrowing();
 		}
 		if (map->TestCollisionGround(box, &pos.y))
 		{
-			if (IsKeyDown(KEY_DOWN))
+			if (world->input.IsDown(Button::DOWN))
 			{
 				StartCrouching();
 			}
-			else if (IsKeyPressed(KEY_SPACE) && !IsKeyDown(KEY_DOWN))
+			else if (world->input.IsPressed(Button::WHIP) && !world->input.IsDown(Button::DOWN))
 			{
 				StartWhip();
 			}
-			else if (IsKeyPressed(KEY_SPACE) && IsKeyDown(KEY_DOWN))
+			else if (world->input.IsPressed(Button::WHIP) && world->input.IsDown(Button::DOWN))
 			{
 				StartCrouchWhip();
 			}
-			else if (IsKeyPressed(KEY_Z) && !IsKeyDown(KEY_DOWN))
+			else if (world->input.IsPressed(Button::THROW) && !world->input.IsDown(Button::DOWN))
 			{
 				StartThrowing();
 			}
-			else if (IsKeyPressed(KEY_Z) && IsKeyDown(KEY_DOWN))
+			else if (world->input.IsPressed(Button::THROW) && world->input.IsDown(Button::DOWN))
 			{
 				StartCrouchThrowing();
 			}
 		}
+		else
+		{
+			pos.y -= probe;
+		}
 	}
 }
 void Player::LogicJumping()
+{
+	//Several steps or none in a tick depending on the tick rate, until the jump is over
+	int steps = FixedStep(PLAYER_JUMP_RATE, jump_carry);
+	for (int i = 0; i < steps && state == State::JUMPING; ++i)
+	{
+		JumpStep();
+	}
+}
+void Player::JumpStep()
 {
 	AABB box, prev_box;
 	int prev_y;
 
-	jump_delay--;
-	if (jump_delay == 0)
-	{
-		prev_y = pos.y;
-		prev_box = GetHitbox();
+	prev_y = pos.y;
+	prev_box = GetHitbox();
 
-		pos.y += dir.y;
-		dir.y += GRAVITY_FORCE;
-		jump_delay = PLAYER_JUMP_DELAY;
+	pos.y += dir.y / PLAYER_JUMP_RATE;
+	dir.y += GRAVITY_FORCE / PLAYER_JUMP_RATE;
 
-		//Is the jump finished?
-		if (dir.y > PLAYER_JUMP_FORCE)
-		{
-			dir.y = PLAYER_SPEED;
-			StartFalling();
-		}
-		else
-		{
-			if (!shield) {
-				if (IsAscending())
-				{
-					if (IsLookingRight())	SetAnimation((int)PlayerAnim::JUMPING_RIGHT);
-					else					SetAnimation((int)PlayerAnim::JUMPING_LEFT);
-				}
-				else if (IsLevitating())
-				{
-					if (IsLookingRight())	SetAnimation((int)PlayerAnim::LEVITATING_RIGHT);
-					else					SetAnimation((int)PlayerAnim::LEVITATING_LEFT);
-				}
-				else if (IsDescending())
-				{
-					if (IsLookingRight())	SetAnimation((int)PlayerAnim::FALLING_RIGHT);
-					else					SetAnimation((int)PlayerAnim::FALLING_LEFT);
-				}
+	//Is the jump finished?
+	if (dir.y > PLAYER_JUMP_FORCE)
+	{
+		dir.y = PLAYER_SPEED;
+		StartFalling();
+	}
+	else
+	{
+		if (!shield) {
+			if (IsAscending())
+			{
+				if (IsLookingRight())	SetAnimation((int)PlayerAnim::JUMPING_RIGHT);
+				else					SetAnimation((int)PlayerAnim::JUMPING_LEFT);
 			}
-			else if (shield) {
-				if (IsAscending())
-				{
-					if (IsLookingRight())	SetAnimation((int)PlayerAnim::JUMPING_RIGHT_SHIELD);
-					else					SetAnimation((int)PlayerAnim::JUMPING_LEFT_SHIELD);
-				}
-				else if (IsLevitating())
-				{
-					if (IsLookingRight())	SetAnimation((int)PlayerAnim::LEVITATING_RIGHT_SHIELD);
-					else					SetAnimation((int)PlayerAnim::LEVITATING_LEFT_SHIELD);
-				}
-				else if (IsDescending())
-				{
-					if (IsLookingRight())	SetAnimation((int)PlayerAnim::FALLING_RIGHT_SHIELD);
-					else					SetAnimation((int)PlayerAnim::FALLING_LEFT_SHIELD);
-				}
+			else if (IsLevitating())
+			{
+				if (IsLookingRight())	SetAnimation((int)PlayerAnim::LEVITATING_RIGHT);
+				else					SetAnimation((int)PlayerAnim::LEVITATING_LEFT);
+			}
+			else if (IsDescending())
+			{
+				if (IsLookingRight())	SetAnimation((int)PlayerAnim::FALLING_RIGHT);
+				else					SetAnimation((int)PlayerAnim::FALLING_LEFT);
 			}
-			//Jumping is represented with 3 different states
 		}
-		//We check ground collision when jumping down
-		if (dir.y >= 0)
-		{
-			box = GetHitbox();
-
-			//A ground collision occurs if we were not in a collision state previously.
-			//This prevents scenarios where, after levitating due to a previous jump, we found
-			//ourselves inside a tile, and the entity would otherwise be placed above the tile,
-			//crossing it.
-			if (!map->TestCollisionGround(prev_box, &prev_y) &&
-				map->TestCollisionGround(box, &pos.y))
+		else if (shield) {
+			if (IsAscending())
 			{
-				Stop();
-				height = PLAYER_PHYSICAL_HEIGHT;
+				if (IsLookingRight())	SetAnimation((int)PlayerAnim::JUMPING_RIGHT_SHIELD);
+				else					SetAnimation((int)PlayerAnim::JUMPING_LEFT_SHIELD);
+			}
+			else if (IsLevitating())
+			{
+				if (IsLookingRight())	SetAnimation((int)PlayerAnim::LEVITATING_RIGHT_SHIELD);
+				else					SetAnimation((int)PlayerAnim::LEVITATING_LEFT_SHIELD);
 			}
+			else if (IsDescending())
+			{
+				if (IsLookingRight())	SetAnimation((int)PlayerAnim::FALLING_RIGHT_SHIELD);
+				else					SetAnimation((int)PlayerAnim::FALLING_LEFT_SHIELD);
+			}
+		}
+		//Jumping is represented with 3 different states
+	}
+	//We check ground collision when jumping down
+	if (dir.y >= 0)
+	{
+		box = GetHitbox();
+
+		//A ground collision occurs if we were not in a collision state previously.
+		//This prevents scenarios where, after levitating due to a previous jump, we found
+		//ourselves inside a tile, and the entity would otherwise be placed above the tile,
+		//crossing it.
+		if (!map->TestCollisionGround(prev_box, &prev_y) &&
+			map->TestCollisionGround(box, &pos.y))
+		{
+			Stop();
+			height = PLAYER_PHYSICAL_HEIGHT;
 		}
 	}
 }
@@ -933,29 +955,29 @@ void Player::LogicClimbing()
 	{
 		Stop();
 	}
-	if (IsKeyDown(KEY_UP) && IsLookingLeft())
+	if (world->input.IsDown(Button::UP) && IsLookingLeft())
 	{
-		pos.y -= 3;
-		pos.x -= PLAYER_LADDER_SPEED;
+		pos.y += StepY(-PLAYER_CLIMB_SPEED);
+		pos.x += FixedStep(-PLAYER_LADDER_SPEED, ladder_carry);
 		sprite->NextFrame();
 	}
-	else if (IsKeyDown(KEY_DOWN) && IsKeyDown(KEY_LEFT))
+	else if (world->input.IsDown(Button::DOWN) && world->input.IsDown(Button::LEFT))
 	{
-		pos.y += PLAYER_LADDER_SPEED;
-		pos.x -= PLAYER_LADDER_SPEED;
+		pos.y += StepY(PLAYER_LADDER_SPEED);
+		pos.x += FixedStep(-PLAYER_LADDER_SPEED, ladder_carry);
 		sprite->PrevFrame();
 	}
 
-	if (IsKeyDown(KEY_UP) && IsLookingRight())
+	if (world->input.IsDown(Button::UP) && IsLookingRight())
 	{
-		pos.y -= 3;
-		pos.x += PLAYER_LADDER_SPEED;
+		pos.y += StepY(-PLAYER_CLIMB_SPEED);
+		pos.x += FixedStep(PLAYER_LADDER_SPEED, ladder_carry);
 		sprite->NextFrame();
 	}
-	else if (IsKeyDown(KEY_DOWN) && IsKeyDown(KEY_RIGHT))
+	else if (world->input.IsDown(Button::DOWN) && world->input.IsDown(Button::RIGHT))
 	{
-		pos.y += PLAYER_LADDER_SPEED;
-		pos.x += PLAYER_LADDER_SPEED;
+		pos.y += StepY(PLAYER_LADDER_SPEED);
+		pos.x += FixedStep(PLAYER_LADDER_SPEED, ladder_carry);
 		sprite->PrevFrame();
 	}
 
@@ -999,13 +1021,13 @@ void Player::LogicClimbing()
 void Player::LogicCrouching() 
 {
 	height = PLAYER_PHYSICAL_CROUCHING_HEIGHT;
-	if (IsKeyPressed(KEY_SPACE)) {
+	if (world->input.IsPressed(Button::WHIP)) {
 		StartCrouchWhip();
 	}
-	else if (IsKeyPressed(KEY_Z)) {
+	else if (world->input.IsPressed(Button::THROW)) {
 		StartCrouchThrowing();
 	}
-	if (IsKeyReleased(KEY_DOWN)) {
+	if (world->input.IsReleased(Button::DOWN)) {
 		Stop();
 		height = PLAYER_PHYSICAL_HEIGHT;
 	}
@@ -1023,7 +1045,7 @@ void Player::LogicThrow()
 
 		if (AnimationFrame == 3) {
 			
-			if (state == State::CROUCH_THROWING && IsKeyDown(KEY_DOWN)) {
+			if (state == State::CROUCH_THROWING && world->input.IsDown(Button::DOWN)) {
 				StartCrouching();
 			}
 			else {
@@ -1057,14 +1079,14 @@ void Player::LogicAttack()
 
 		if (AnimationFrame == 3) {
 
-			if (state == State::CROUCH_WHIP && IsKeyDown(KEY_DOWN)) {
+			if (state == State::CROUCH_WHIP && world->input.IsDown(Button::DOWN)) {
 				StartCrouching();
 			}
 			else {
 				Stop();
 			}
 
-			AudioPlayer::Instance().PlaySoundByName("MissAttack");
+			world->audio.PlaySoundByName("MissAttack");
 
 			sprite->SetAutomaticMode();
 			AnimationFrame = 0;
@@ -1109,12 +1131,12 @@ void Player::LogicDamaged()
 	die_delay--;
 	if (die_delay > PLAYER_DYING_DELAY / 2) {
 		if (look == Look::RIGHT) {
-			pos.x -= PLAYER_SPEED;
+			pos.x += StepX(-PLAYER_SPEED);
 		}
 		else {
-			pos.x += PLAYER_SPEED;
+			pos.x += StepX(PLAYER_SPEED);
 		}
-		pos.y -= PLAYER_SPEED;
+		pos.y += StepY(-PLAYER_SPEED);
 	}
 	if (die_delay <= 0)
 	{
@@ -1148,10 +1170,54 @@ void Player::DrawDebug(const Color& col) const
 }
 void Player::Release()
 {
-	weapon->Release();
+	//The weapon releases its texture when it is deleted, Release() can be called more than once
 	render->Release();
 }
 State Player::GetState() const
 {
 	return state;
 }
+void Player::SaveState(BinaryWriter& out) const
+{
+	Entity::SaveState(out);
+	out.WriteBool(damaged_finished);
+	out.WriteBool(GodMode);
+	out.WriteEnum(state);
+	out.WriteEnum(look);
+	out.Write(jump_carry);
+	out.Write(ladder_carry);
+	out.Write(attack_delay);
+	out.Write(damaged_delay);
+	out.Write(die_delay);
+	out.Write(AnimationFrame);
+	out.WriteBool(chestKey);
+	out.WriteBool(doorKey);
+	out.WriteBool(shield);
+	out.Write(score);
+	out.Write(lives);
+	out.Write(life);
+	out.Write(hearts);
+	weapon->SaveState(out);
+}
+void Player::LoadState(BinaryReader& in)
+{
+	Entity::LoadState(in);
+	in.ReadBool(damaged_finished);
+	in.ReadBool(GodMode);
+	in.ReadEnum(state);
+	in.ReadEnum(look);
+	in.Read(jump_carry);
+	in.Read(ladder_carry);
+	in.Read(attack_delay);
+	in.Read(damaged_delay);
+	in.Read(die_delay);
+	in.Read(AnimationFrame);
+	in.ReadBool(chestKey);
+	in.ReadBool(doorKey);
+	in.ReadBool(shield);
+	in.Read(score);
+	in.Read(lives);
+	in.Read(life);
+	in.Read(hearts);
+	weapon->LoadState(in);
+}
@@ -17,35 +17,43 @@
 #define PLAYER_INIT_LIVES		2
 #define PLAYER_MAX_LIFE			32
 
+//Speeds are in pixels per second and gravity in pixels per second squared, see FixedStep()
+
 //Horizontal speed and vertical speed while falling down
-#define PLAYER_SPEED			1
+#define PLAYER_SPEED			60
+
+//Speed on a ladder, horizontal and going down
+#define PLAYER_LADDER_SPEED		60
 
-//Vertical speed while on a ladder
-#define PLAYER_LADDER_SPEED		1
+//Vertical speed going up a ladder
+#define PLAYER_CLIMB_SPEED		180
 
 //Frame animation delay while on a ladder
 #define ANIM_LADDER_DELAY		(2*ANIM_DELAY)
 
 //When jumping, initial jump speed and maximum falling speed
-#define PLAYER_JUMP_FORCE		10
+#define PLAYER_JUMP_FORCE		300
 
-//Frame delay for updating the jump velocity
-#define PLAYER_JUMP_DELAY		2
+//Jumps advance in steps at this rate per second whatever the tick rate, so every rate draws
+//the same arc
+#define PLAYER_JUMP_RATE		30
+//The jump carry starts half a step behind, so FixedStep() rounds to each step once it has elapsed
+#define PLAYER_JUMP_CARRY		(-SIM_TICKS_PER_SECOND / 2)
 
 //Frame delay for updating the attack velocity
-#define PLAYER_ATTACK_DELAY		6
+#define PLAYER_ATTACK_DELAY		TIME_TO_PERIOD(0.1)
 
 //Frame delay for updating the dying velocity
-#define PLAYER_DYING_DELAY		20
+#define PLAYER_DYING_DELAY		TIME_TO_PERIOD(0.333)
 
 //Frame delay for updating the being damaged velocity
-#define PLAYER_DAMAGED_DELAY	3*60
+#define PLAYER_DAMAGED_DELAY	TIME_TO_TICKS(3.0)
 
 //Player is levitating when abs(speed) <= this value
-#define PLAYER_LEVITATING_SPEED	4
+#define PLAYER_LEVITATING_SPEED	120
 
-//Gravity affects jumping velocity when jump_delay is 0
-#define GRAVITY_FORCE			1
+//Gravity affects jumping velocity on every jump step
+#define GRAVITY_FORCE			900
 
 //Logic states
 enum class State {
@@ -85,10 +93,12 @@ enum class PlayerAnim {
 	NUM_ANIMATIONS
 };
 
+class World;
+
 class Player: public Entity
 {
 public:
-	Player(const Point& p, State s, Look view);
+	Player(const Point& p, State s, Look view, World* world);
 	~Player();
 	
 	AppStatus Initialise();
@@ -121,6 +131,10 @@ public:
 	void DrawDebug(const Color& col) const;
 	void Release();
 	State GetState() const;
+
+	//Snapshot of the mechanics, the inventory, the HUD numbers and the weapon
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
 	
 	bool IsGodMode() const;
 	bool IsDead() const;
@@ -135,8 +149,10 @@ public:
 	//Inventory management
 	bool HasChestKey() const;
 	void SwitchChestKey();
+	void SetChestKey(bool has);
 	bool HasDoorKey() const;
 	void SwitchDoorKey();
+	void SetDoorKey(bool has);
 	bool HasShield() const;
 	void SwitchShield();
 
@@ -147,12 +163,14 @@ public:
 	bool IsLookingRight() const;
 	bool IsLookingLeft() const;
 private:
+	World* world;
 
 	//Player mechanics
 	void MoveX();
 	void MoveY();
 	void Static();
 	void LogicJumping();
+	void JumpStep();
 	void LogicClimbing();
 	void LogicCrouching();
 	void LogicThrow();
@@ -189,7 +207,9 @@ private:
 	bool GodMode;
 	State state;
 	Look look;
-	int jump_delay;
+	int jump_carry;
+	//Sideways ladder moves carry their own fraction, apart from the walking one a wall can undo
+	int ladder_carry;
 	int attack_delay;
 	int	damaged_delay;
 	int	die_delay;
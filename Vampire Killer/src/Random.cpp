@@ -0,0 +1,45 @@
+#include "Random.h"
+
+Random::Random(unsigned int seed)
+{
+	Seed(seed);
+}
+Random::~Random()
+{
+}
+void Random::Seed(unsigned int seed)
+{
+	//splitmix64 spreads small seeds over the whole state, which can't be zero
+	unsigned long long z = seed + 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	state = z ^ (z >> 31);
+	if (state == 0) state = 0x9E3779B97F4A7C15ull;
+}
+unsigned int Random::Next()
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return (unsigned int)((state * 0x2545F4914F6CDD1Dull) >> 32);
+}
+int Random::Range(int min, int max)
+{
+	if (min > max)
+	{
+		int tmp = min;
+		min = max;
+		max = tmp;
+	}
+	unsigned int span = (unsigned int)(max - min) + 1;
+	if (span == 0) return (int)Next();
+	return min + (int)(Next() % span);
+}
+unsigned long long Random::GetState() const
+{
+	return state;
+}
+void Random::SetState(unsigned long long s)
+{
+	if (s != 0) state = s;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+//Seed of the worlds created by the game, simulations pass their own
+#define RANDOM_DEFAULT_SEED		1
+
+//Seeded xorshift64* stream. Every world owns one so simulations running side by side don't share
+//a sequence, and the state is saved with the snapshots so a restored game draws the same values.
+class Random
+{
+public:
+    Random(unsigned int seed);
+    ~Random();
+
+    void Seed(unsigned int seed);
+
+    unsigned int Next();
+    //Value in [min, max], same as raylib's GetRandomValue
+    int Range(int min, int max);
+
+    unsigned long long GetState() const;
+    void SetState(unsigned long long state);
+
+private:
+    unsigned long long state;
+};
@@ -1,10 +1,22 @@
 
 #include "RenderComponent.h"
 #include "raylib.h"
+#include "MemTracker.h"
+#include <new>
 
 RenderComponent::~RenderComponent()
 {
 }
+void* RenderComponent::operator new(size_t size)
+{
+	void* ptr = MemTracker::Allocate(size, MemTag::SPRITES);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+void RenderComponent::operator delete(void* ptr)
+{
+	MemTracker::Free(ptr);
+}
 void RenderComponent::DrawBox(int x, int y, int w, int h, const Color& col) const
 {
 	Rectangle rc;
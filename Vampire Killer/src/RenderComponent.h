@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include "raylib.h"
 
 class RenderComponent
@@ -7,6 +8,10 @@ public:
     //Virtual destructor to ensure proper destruction of derived class objects
     virtual ~RenderComponent();
 
+    //Sprites and images are charged to MemTag::SPRITES wherever they are created
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
     //Pure virtual functions, any class inheriting from this class must provide its own implementations
     virtual void Draw(int x, int y) const = 0;
     virtual void DrawTint(int x, int y, const Color& col) const = 0;
@@ -0,0 +1,184 @@
+#include "RenderQueue.h"
+#include "SoftwareRenderer.h"
+#include "rlgl.h"
+#include <algorithm>
+
+RenderQueue::RenderQueue()
+{
+	layer = RenderLayer::BACKGROUND;
+	software = nullptr;
+	last_pushed = 0;
+	last_submitted = 0;
+	stats = {};
+	last_stats = {};
+}
+RenderQueue::~RenderQueue()
+{
+}
+void RenderQueue::BeginFrame()
+{
+	last_stats = stats;
+	stats = {};
+	pending.clear();
+	submitted.clear();
+	layer = RenderLayer::BACKGROUND;
+	last_pushed = 0;
+	last_submitted = 0;
+}
+void RenderQueue::SetSoftwareTarget(SoftwareRenderer* renderer)
+{
+	Flush();
+	software = renderer;
+}
+void RenderQueue::BeginCamera(const Camera2D& camera)
+{
+	Flush();
+	if (software != nullptr)	software->SetCamera(camera);
+	else						BeginMode2D(camera);
+}
+void RenderQueue::EndCamera()
+{
+	Flush();
+	if (software != nullptr)	software->ResetCamera();
+	else						EndMode2D();
+}
+void RenderQueue::SetLayer(RenderLayer layer)
+{
+	this->layer = layer;
+}
+RenderLayer RenderQueue::GetLayer() const
+{
+	return layer;
+}
+void RenderQueue::PushTexture(const Texture2D& texture, int x, int y, const Color& tint)
+{
+	Rectangle src = { 0, 0, (float)texture.width, (float)texture.height };
+	PushTextureRec(texture, src, { (float)x, (float)y }, tint);
+}
+void RenderQueue::PushTextureRec(const Texture2D& texture, const Rectangle& src, const Vector2& pos, const Color& tint)
+{
+	//Same as raylib, a texture that failed to load draws nothing
+	if (texture.id == 0) return;
+
+	DrawCommand command;
+	command.texture = texture.id;
+	command.texture_width = texture.width;
+	command.texture_height = texture.height;
+	command.src = src;
+	command.dst = { pos.x, pos.y, src.width < 0 ? -src.width : src.width, src.height < 0 ? -src.height : src.height };
+	command.tint = tint;
+	command.solid = false;
+	Push(command);
+}
+void RenderQueue::PushRectangle(int x, int y, int width, int height, const Color& col)
+{
+	//raylib draws shapes with its 1x1 white texture, so rectangles batch with sprites
+	DrawCommand command;
+	command.texture = rlGetTextureIdDefault();
+	command.texture_width = 1;
+	command.texture_height = 1;
+	command.src = { 0, 0, 1, 1 };
+	command.dst = { (float)x, (float)y, (float)width, (float)height };
+	command.tint = col;
+	command.solid = true;
+	Push(command);
+}
+void RenderQueue::Push(const DrawCommand& command)
+{
+	pending.push_back(command);
+	pending.back().layer = layer;
+	pending.back().sequence = stats.commands;
+
+	stats.commands++;
+	if (command.texture != last_pushed) stats.unsorted_switches++;
+	last_pushed = command.texture;
+}
+void RenderQueue::Flush()
+{
+	if (pending.empty()) return;
+
+	std::sort(pending.begin(), pending.end(), [](const DrawCommand& a, const DrawCommand& b) {
+		if (a.layer != b.layer) return a.layer < b.layer;
+		if (a.texture != b.texture) return a.texture < b.texture;
+		return a.sequence < b.sequence;
+	});
+
+	//One rlBegin() per run of the same texture, rlgl splits the batch itself when it is full
+	bool gpu = software == nullptr;
+	bool first = true;
+	unsigned int current = 0;
+	for (const DrawCommand& command : pending)
+	{
+		if (first || command.texture != current)
+		{
+			if (gpu)
+			{
+				if (!first) rlEnd();
+				rlSetTexture(command.texture);
+				rlBegin(RL_QUADS);
+			}
+			first = false;
+			current = command.texture;
+
+			stats.draw_calls++;
+			if (command.texture != last_submitted) stats.texture_switches++;
+			last_submitted = command.texture;
+		}
+		if (gpu) Submit(command);
+		submitted.push_back(command);
+	}
+	if (gpu)
+	{
+		rlEnd();
+		rlSetTexture(0);
+	}
+	else
+	{
+		software->Draw(pending.data(), (int)pending.size());
+	}
+
+	pending.clear();
+}
+void RenderQueue::Submit(const DrawCommand& command)
+{
+	//Texture coordinates as DrawTexturePro() computes them, including the flips
+	Rectangle src = command.src;
+	bool flip_x = false;
+	if (src.width < 0)
+	{
+		flip_x = true;
+		src.width = -src.width;
+	}
+	if (src.height < 0) src.y -= src.height;
+
+	float left = src.x / command.texture_width;
+	float right = (src.x + src.width) / command.texture_width;
+	float top = src.y / command.texture_height;
+	float bottom = (src.y + src.height) / command.texture_height;
+	if (flip_x) std::swap(left, right);
+
+	const Rectangle& dst = command.dst;
+	rlColor4ub(command.tint.r, command.tint.g, command.tint.b, command.tint.a);
+	rlNormal3f(0.0f, 0.0f, 1.0f);
+
+	rlTexCoord2f(left, top);
+	rlVertex2f(dst.x, dst.y);
+	rlTexCoord2f(left, bottom);
+	rlVertex2f(dst.x, dst.y + dst.height);
+	rlTexCoord2f(right, bottom);
+	rlVertex2f(dst.x + dst.width, dst.y + dst.height);
+	rlTexCoord2f(right, top);
+	rlVertex2f(dst.x + dst.width, dst.y);
+}
+const std::vector<DrawCommand>& RenderQueue::GetSubmitted() const
+{
+	return submitted;
+}
+const RenderStats& RenderQueue::GetStats() const
+{
+	return stats;
+}
+const RenderStats& RenderQueue::GetLastStats() const
+{
+	return last_stats;
+}
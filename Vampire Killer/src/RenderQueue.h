@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include "raylib.h"
+
+class SoftwareRenderer;
+
+//Draw order of the commands, a layer is drawn on top of the previous ones. Inside a layer the
+//commands are grouped by texture, so sprites that overlap must go to different layers.
+enum class RenderLayer {
+    BACKGROUND, TILES, OBJECTS, ENEMIES, ITEMS, PLAYER, WEAPON, FOREGROUND, GAME_OVER,
+    HUD_BACKGROUND, HUD, HUD_FRAME
+};
+
+//Textured quad waiting to be submitted
+struct DrawCommand
+{
+    unsigned int texture;
+    int texture_width, texture_height;
+    //A negative width or height flips the image like DrawTextureRec() does
+    Rectangle src;
+    Rectangle dst;
+    Color tint;
+    //Filled rectangle, drawn with the default white texture
+    bool solid;
+    RenderLayer layer;
+    //Position in the frame, keeps the drawing order of commands with the same layer and texture
+    int sequence;
+};
+
+struct RenderStats
+{
+    int commands;
+    //Runs of commands sharing a texture, rlgl issues one draw call for each
+    int draw_calls;
+    int texture_switches;
+    //Texture switches the same commands would have needed in the order they were drawn
+    int unsorted_switches;
+};
+
+//Sprites, tiles and text are not drawn at once: they are recorded with the current layer and,
+//on Flush(), sorted by layer and texture and sent to rlgl as quads. rlgl only breaks the batch
+//when the texture changes, so sorting turns a few hundred small draws into a handful.
+//There is one queue per thread, bots render their frames in parallel with the software renderer.
+class RenderQueue
+{
+public:
+    static RenderQueue& Instance()
+    {
+        static thread_local RenderQueue instance; //One per thread, initialized on first use
+        return instance;
+    }
+
+    //Send the commands to a software renderer instead of rlgl, nullptr goes back to rlgl
+    //Only the queued commands are drawn, nothing may call raylib's drawing functions directly
+    void SetSoftwareTarget(SoftwareRenderer* renderer);
+
+    //Flush and apply the camera transform to the commands that follow, like BeginMode2D()
+    void BeginCamera(const Camera2D& camera);
+    void EndCamera();
+
+    //Start a new frame, the stats of the previous one are kept for GetLastStats()
+    void BeginFrame();
+
+    //Layer of the commands pushed from now on
+    void SetLayer(RenderLayer layer);
+    RenderLayer GetLayer() const;
+
+    void PushTexture(const Texture2D& texture, int x, int y, const Color& tint);
+    void PushTextureRec(const Texture2D& texture, const Rectangle& src, const Vector2& pos, const Color& tint);
+    void PushRectangle(int x, int y, int width, int height, const Color& col);
+
+    //Sort the pending commands and submit them, must be called before drawing anything
+    //directly and before the camera or the render target change
+    void Flush();
+
+    //Commands submitted since BeginFrame() in the order they reached rlgl
+    const std::vector<DrawCommand>& GetSubmitted() const;
+    const RenderStats& GetStats() const;
+    const RenderStats& GetLastStats() const;
+
+private:
+    RenderQueue();
+    ~RenderQueue();
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    void Push(const DrawCommand& command);
+    void Submit(const DrawCommand& command);
+
+    std::vector<DrawCommand> pending;
+    std::vector<DrawCommand> submitted;
+    RenderLayer layer;
+    SoftwareRenderer* software;
+
+    //Texture of the last pushed and the last submitted command, 0 when there is none
+    unsigned int last_pushed;
+    unsigned int last_submitted;
+
+    RenderStats stats;
+    RenderStats last_stats;
+};
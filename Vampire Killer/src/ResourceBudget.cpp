@@ -0,0 +1,156 @@
+#include "ResourceBudget.h"
+#include "Globals.h"
+#include "raylib.h"
+#include <algorithm>
+
+static const char* kind_names[(int)ResourceKind::COUNT] = { "Textures", "Sounds", "Music" };
+static const char* owner_names[(int)ResourceOwner::COUNT] = { "Game", "Scene", "Enemies" };
+
+ResourceBudget::ResourceBudget()
+{
+    for (int i = 0; i < (int)ResourceKind::COUNT; ++i)
+    {
+        budgets[i] = 0;
+        warned[i] = false;
+    }
+}
+ResourceBudget::~ResourceBudget()
+{
+}
+void ResourceBudget::Add(ResourceKind kind, ResourceOwner owner, unsigned long long key, const std::string& name, size_t bytes)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    ResourceEntry entry;
+    entry.kind = kind;
+    entry.owner = owner;
+    entry.key = key;
+    entry.name = name;
+    entry.bytes = bytes;
+    entries.push_back(entry);
+
+    size_t total = Total(kind);
+    size_t budget = budgets[(int)kind];
+    if (budget > 0 && total > budget && !warned[(int)kind])
+    {
+        LOG("Budget: %s use %d KB after loading %s, over the budget of %d KB", kind_names[(int)kind],
+            (int)(total / 1024), name.c_str(), (int)(budget / 1024));
+        warned[(int)kind] = true;
+    }
+}
+void ResourceBudget::Remove(ResourceKind kind, unsigned long long key)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].kind == kind && entries[i].key == key)
+        {
+            entries.erase(entries.begin() + i);
+            break;
+        }
+    }
+    if (Total(kind) <= budgets[(int)kind]) warned[(int)kind] = false;
+}
+size_t ResourceBudget::Total(ResourceKind kind) const
+{
+    size_t total = 0;
+    for (const ResourceEntry& entry : entries)
+    {
+        if (entry.kind == kind) total += entry.bytes;
+    }
+    return total;
+}
+size_t ResourceBudget::GetTotal(ResourceKind kind) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return Total(kind);
+}
+size_t ResourceBudget::GetTotal(ResourceKind kind, ResourceOwner owner) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    size_t total = 0;
+    for (const ResourceEntry& entry : entries)
+    {
+        if (entry.kind == kind && entry.owner == owner) total += entry.bytes;
+    }
+    return total;
+}
+std::vector<ResourceEntry> ResourceBudget::GetEntries() const
+{
+    std::vector<ResourceEntry> sorted;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        sorted = entries;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ResourceEntry& a, const ResourceEntry& b) {
+        return a.bytes > b.bytes;
+    });
+    return sorted;
+}
+void ResourceBudget::SetBudget(ResourceKind kind, size_t bytes)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    budgets[(int)kind] = bytes;
+    warned[(int)kind] = false;
+}
+size_t ResourceBudget::GetBudget(ResourceKind kind) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return budgets[(int)kind];
+}
+bool ResourceBudget::IsOverBudget(ResourceKind kind) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return budgets[(int)kind] > 0 && Total(kind) > budgets[(int)kind];
+}
+void ResourceBudget::Dump() const
+{
+    std::vector<ResourceEntry> sorted = GetEntries();
+    for (int kind = 0; kind < (int)ResourceKind::COUNT; ++kind)
+    {
+        size_t budget = GetBudget((ResourceKind)kind);
+        int total_kb = (int)(GetTotal((ResourceKind)kind) / 1024);
+        if (budget > 0)
+        {
+            LOG("%s: %d KB of a %d KB budget", kind_names[kind], total_kb, (int)(budget / 1024));
+        }
+        else
+        {
+            LOG("%s: %d KB", kind_names[kind], total_kb);
+        }
+
+        for (int owner = 0; owner < (int)ResourceOwner::COUNT; ++owner)
+        {
+            size_t total = GetTotal((ResourceKind)kind, (ResourceOwner)owner);
+            if (total > 0) LOG("  %s: %d KB", owner_names[owner], (int)(total / 1024));
+        }
+        for (const ResourceEntry& entry : sorted)
+        {
+            if ((int)entry.kind == kind)
+            {
+                LOG("    %7d bytes  %-8s %s", (int)entry.bytes, owner_names[(int)entry.owner], entry.name.c_str());
+            }
+        }
+    }
+}
+const char* ResourceBudget::GetKindName(ResourceKind kind)
+{
+    return kind_names[(int)kind];
+}
+const char* ResourceBudget::GetOwnerName(ResourceOwner owner)
+{
+    return owner_names[(int)owner];
+}
+size_t ResourceBudget::GetTextureSize(int width, int height, int format, int mipmaps)
+{
+    size_t size = 0;
+    for (int level = 0; level < (mipmaps > 0 ? mipmaps : 1); ++level)
+    {
+        size += (size_t)GetPixelDataSize(width, height, format);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return size;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <mutex>
+
+//Who loaded a resource, the breakdown groups the memory by owner
+enum class ResourceOwner { GAME, SCENE, ENEMIES, COUNT };
+
+//Textures take VRAM, sounds keep their decoded PCM and music only the buffers of its stream
+enum class ResourceKind { TEXTURE, SOUND, MUSIC, COUNT };
+
+//raylib streams have two sub-buffers of this many frames (sample rate / 30 by default)
+#define AUDIO_STREAM_BUFFER_FRAMES(sample_rate)	((sample_rate) / 30)
+#define AUDIO_STREAM_BUFFERS					2
+
+struct ResourceEntry
+{
+    ResourceKind kind;
+    ResourceOwner owner;
+    //Identifies the resource inside its kind, set by the manager that loaded it
+    unsigned long long key;
+    std::string name;
+    size_t bytes;
+};
+
+//Memory used by the textures and the audio loaded by ResourceManager and AudioPlayer. Each kind
+//can have a budget, loading past it writes a warning to the log once until the memory drops
+//below the budget again.
+class ResourceBudget
+{
+public:
+    static ResourceBudget& Instance()
+    {
+        static ResourceBudget instance; //Guaranteed to be initialized only once
+        return instance;
+    }
+
+    void Add(ResourceKind kind, ResourceOwner owner, unsigned long long key, const std::string& name, size_t bytes);
+    void Remove(ResourceKind kind, unsigned long long key);
+
+    size_t GetTotal(ResourceKind kind) const;
+    size_t GetTotal(ResourceKind kind, ResourceOwner owner) const;
+    //Every resource loaded, the largest first
+    std::vector<ResourceEntry> GetEntries() const;
+
+    //Budget in bytes, 0 for none
+    void SetBudget(ResourceKind kind, size_t bytes);
+    size_t GetBudget(ResourceKind kind) const;
+    bool IsOverBudget(ResourceKind kind) const;
+
+    //Write every resource and the totals to the log
+    void Dump() const;
+
+    static const char* GetKindName(ResourceKind kind);
+    static const char* GetOwnerName(ResourceOwner owner);
+
+    //Bytes of a texture in VRAM, every mipmap level included
+    static size_t GetTextureSize(int width, int height, int format, int mipmaps);
+
+    ResourceBudget(const ResourceBudget&) = delete;
+    ResourceBudget& operator=(const ResourceBudget&) = delete;
+
+private:
+    ResourceBudget();
+    ~ResourceBudget();
+
+    size_t Total(ResourceKind kind) const;
+
+    std::vector<ResourceEntry> entries;
+    size_t budgets[(int)ResourceKind::COUNT];
+    //Warned since the kind went over its budget
+    bool warned[(int)ResourceKind::COUNT];
+
+    //Textures are loaded from several threads by the bots
+    mutable std::mutex lock;
+};
@@ -1,8 +1,44 @@
 #include "ResourceManager.h"
+#include "JobSystem.h"
+#include "MemTracker.h"
+#include "ResourceBudget.h"
+#include <vector>
 
+//Textures of the intro screens and the menus belong to the game, the ones of the enemies
+//to the enemy manager and the rest to the scene
+static ResourceOwner GetOwner(Resource id)
+{
+    switch (id)
+    {
+    case Resource::IMG_MENU:
+    case Resource::IMG_MENU_PLAY:
+    case Resource::IMG_MENU_EMPTY:
+    case Resource::IMG_INTRO_UPC:
+    case Resource::IMG_INTRO_BACKGROUND:
+    case Resource::IMG_INTRODUCTION:
+    case Resource::IMG_INTRO_BAT:
+    case Resource::IMG_INTRO_CLOUD:
+    case Resource::IMG_GAME_WIN:
+    case Resource::IMG_HUD_INTRO:
+        return ResourceOwner::GAME;
+    case Resource::IMG_ZOMBIE:
+    case Resource::IMG_PANTHER:
+    case Resource::IMG_BAT:
+    case Resource::IMG_TRADER:
+    case Resource::IMG_BOSS:
+        return ResourceOwner::ENEMIES;
+    default:
+        return ResourceOwner::SCENE;
+    }
+}
 
 ResourceManager::ResourceManager()
 {
+    headless = false;
+    keep_images = false;
+
+    //Created first so it is destroyed after the textures released by the destructor
+    ResourceBudget::Instance();
 }
 ResourceManager::~ResourceManager()
 {
@@ -12,37 +48,157 @@ ResourceManager::~ResourceManager()
 //Load a texture from a file and associate it with the key id
 AppStatus ResourceManager::LoadTexture(Resource id, const std::string& file_path)
 {
+    std::lock_guard<std::mutex> guard(lock);
+    MemScope scope(MemTag::RESOURCES);
+
+    //Already loaded by another user, share it
+    if (textures.find(id) != textures.end())
+    {
+        references[id]++;
+        return AppStatus::OK;
+    }
+
     //Load the texture
-    Texture2D texture = ::LoadTexture(file_path.c_str());
-    if (texture.id == 0)
+    Image image = LoadImage(file_path.c_str());
+    if (image.data == nullptr)
     {
         //Error loading texture
-        LOG("Failed to load texture ", file_path);
+        LOG("Failed to load texture %s", file_path.c_str());
+        return AppStatus::ERROR;
+    }
+    Texture2D texture = CreateTexture(id, image, file_path.c_str());
+    UnloadImage(image);
+    if (texture.id == 0 && !headless)
+    {
+        LOG("Failed to load texture %s", file_path.c_str());
         return AppStatus::ERROR;
     }
     
     //Insert the loaded texture into the map with the specified key
     textures[id] = texture;
+    references[id] = 1;
     return AppStatus::OK;
 }
 
+//Load a list of textures, image decoding runs in parallel
+AppStatus ResourceManager::LoadTextures(const TextureRequest* requests, int count)
+{
+    MemScope scope(MemTag::RESOURCES);
+    std::vector<Image> images(count);
+    JobSystem::Instance().ParallelFor(count, 1, [&images, requests](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            images[i] = LoadImage(requests[i].file_path);
+        }
+    });
+
+    return AddImages(requests, images, count);
+}
+AppStatus ResourceManager::AddImages(const TextureRequest* requests, std::vector<Image>& images, int count)
+{
+    //GPU uploads must be done by the thread owning the OpenGL context
+    std::lock_guard<std::mutex> guard(lock);
+    MemScope scope(MemTag::RESOURCES);
+    AppStatus status = AppStatus::OK;
+    for (int i = 0; i < count; ++i)
+    {
+        if (images[i].data == nullptr)
+        {
+            LOG("Failed to load texture %s", requests[i].file_path);
+            status = AppStatus::ERROR;
+            continue;
+        }
+        Resource id = requests[i].id;
+        if (textures.find(id) != textures.end())
+        {
+            references[id]++;
+            UnloadImage(images[i]);
+            continue;
+        }
+        Texture2D texture = CreateTexture(id, images[i], requests[i].file_path);
+        UnloadImage(images[i]);
+        if (texture.id == 0 && !headless)
+        {
+            LOG("Failed to load texture %s", requests[i].file_path);
+            status = AppStatus::ERROR;
+            continue;
+        }
+        textures[id] = texture;
+        references[id] = 1;
+    }
+    return status;
+}
+
+//Decode a list of textures in the background, one job per file
+void ResourceManager::PreloadTextures(const TextureRequest* requests, int count)
+{
+    //Only one preload at a time
+    if (!preload_requests.empty()) return;
+    MemScope scope(MemTag::RESOURCES);
+
+    preload_requests.assign(requests, requests + count);
+    preload_images.assign(count, Image());
+    for (int i = 0; i < count; ++i)
+    {
+        JobSystem::Instance().Submit([this, i]() {
+            preload_images[i] = LoadImage(preload_requests[i].file_path);
+        }, preload_jobs);
+    }
+}
+bool ResourceManager::FinishPreload()
+{
+    if (preload_requests.empty()) return true;
+    if (preload_jobs.pending.load() > 0) return false;
+
+    //Every decoded image adds a reference, either to a new texture or to one already loaded
+    for (int i = 0; i < (int)preload_requests.size(); ++i)
+    {
+        if (preload_images[i].data != nullptr) preloaded.push_back(preload_requests[i].id);
+    }
+    AddImages(preload_requests.data(), preload_images, (int)preload_requests.size());
+    preload_requests.clear();
+    preload_images.clear();
+    return true;
+}
+void ResourceManager::ReleasePreloaded()
+{
+    //A preload still decoding is finished first so no job writes into a released list
+    if (!preload_requests.empty())
+    {
+        JobSystem::Instance().Wait(preload_jobs);
+        FinishPreload();
+    }
+    for (Resource id : preloaded)
+    {
+        ReleaseTexture(id);
+    }
+    preloaded.clear();
+}
+
 //Release the texture associated with the key id
 void ResourceManager::ReleaseTexture(Resource id)
 {
+    std::lock_guard<std::mutex> guard(lock);
+
     //Find the texture associated with the key
     auto it = textures.find(id);
 
-    //If found, unload the texture and remove it from the map
+    //If found and this was the last user, unload the texture and remove it from the map
     if (it != textures.end())
     {
-        UnloadTexture(it->second);
+        if (--references[id] > 0) return;
+
+        UnloadTextureData(it->second);
         textures.erase(it);
+        references.erase(id);
     }
 }
 
 //Get a texture by key
 const Texture2D* ResourceManager::GetTexture(Resource id) const
 {
+    std::lock_guard<std::mutex> guard(lock);
+
     //Find the texture associated with the key and return it
     auto it = textures.find(id);
     if (it != textures.end())   return &(it->second);
@@ -51,11 +207,76 @@ const Texture2D* ResourceManager::GetTexture(Resource id) const
     return nullptr;
 }
 
+void ResourceManager::SetHeadless(bool value)
+{
+    headless = value;
+}
+bool ResourceManager::IsHeadless() const
+{
+    return headless;
+}
+void ResourceManager::SetKeepImages(bool keep)
+{
+    keep_images = keep;
+}
+const Image* ResourceManager::GetImage(unsigned int texture_id) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = images.find(texture_id);
+    if (it != images.end())     return &(it->second);
+    return nullptr;
+}
+
 void ResourceManager::Release()
 {
+    std::lock_guard<std::mutex> guard(lock);
+
     for (auto& pair : textures)
     {
-        UnloadTexture(pair.second);
+        UnloadTextureData(pair.second);
     }
     textures.clear();
+    references.clear();
+}
+
+Texture2D ResourceManager::CreateTexture(Resource id, const Image& image, const char* file_path)
+{
+    Texture2D texture = {};
+    if (!headless)
+    {
+        texture = LoadTextureFromImage(image);
+    }
+    else
+    {
+        texture.id = HEADLESS_TEXTURE_ID + (unsigned int)id;
+        texture.width = image.width;
+        texture.height = image.height;
+        texture.mipmaps = 1;
+        texture.format = image.format;
+    }
+
+    if (keep_images && texture.id != 0)
+    {
+        Image copy = ImageCopy(image);
+        ImageFormat(&copy, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        images[texture.id] = copy;
+    }
+    if (texture.id != 0)
+    {
+        ResourceBudget::Instance().Add(ResourceKind::TEXTURE, GetOwner(id), texture.id, file_path,
+            ResourceBudget::GetTextureSize(texture.width, texture.height, texture.format, texture.mipmaps));
+    }
+    return texture;
+}
+void ResourceManager::UnloadTextureData(const Texture2D& texture)
+{
+    ResourceBudget::Instance().Remove(ResourceKind::TEXTURE, texture.id);
+    auto it = images.find(texture.id);
+    if (it != images.end())
+    {
+        UnloadImage(it->second);
+        images.erase(it);
+    }
+    if (!headless && texture.id != 0) UnloadTexture(texture);
 }
\ No newline at end of file
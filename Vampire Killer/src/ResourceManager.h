@@ -4,6 +4,9 @@
 #include "Globals.h"
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <mutex>
+#include "JobSystem.h"
 
 enum class Resource {
     IMG_MENU,
@@ -34,6 +37,17 @@ enum class Resource {
     IMG_BOSS
 };
 
+//Headless textures have no OpenGL texture, their ids only name them for the software renderer.
+//They are fixed per resource so draw commands sort the same way in every run.
+#define HEADLESS_TEXTURE_ID		1000
+
+struct TextureRequest {
+    Resource id;
+    const char* file_path;
+};
+
+//Textures shared by every world of the process. Each LoadTexture() of an id must be
+//matched by a ReleaseTexture(), the texture is unloaded when the last user releases it.
 class ResourceManager {
 public:
     //Singleton instance retrieval
@@ -47,9 +61,31 @@ public:
     AppStatus LoadTexture(Resource id, const std::string& file_path);
     void ReleaseTexture(Resource id);
 
+    //Load several textures, the files are decoded in parallel by the job system and
+    //uploaded to the GPU on the calling thread
+    AppStatus LoadTextures(const TextureRequest* requests, int count);
+
+    //Start decoding the files on the job system and return at once, used to load the next
+    //state's textures while the current one is still running
+    void PreloadTextures(const TextureRequest* requests, int count);
+    //Create the textures of the preload once every file is decoded, returns false while it is
+    //still running. Preloaded textures keep a reference until ReleasePreloaded().
+    bool FinishPreload();
+    void ReleasePreloaded();
+
     //Get texture by key
     const Texture2D* GetTexture(Resource id) const;
 
+    //Without a window there is no OpenGL context: images are only decoded to get their size
+    //and each texture gets the id HEADLESS_TEXTURE_ID + its resource
+    void SetHeadless(bool headless);
+    bool IsHeadless() const;
+
+    //Keep an RGBA copy of every texture loaded from now on for the software renderer
+    void SetKeepImages(bool keep);
+    //CPU copy of a texture, nullptr when it was not kept
+    const Image* GetImage(unsigned int texture_id) const;
+
     //Release resources
     void Release();
 
@@ -63,6 +99,28 @@ private:
     //Destructor
     ~ResourceManager();
 
-    //Dictionary to store loaded textures
+    //Create the texture of a decoded image, or only keep its size when headless
+    //Its size is added to the texture budget under the owner of the resource
+    Texture2D CreateTexture(Resource id, const Image& image, const char* file_path);
+    //Create the textures of decoded images and unload the images, the ids already loaded get a new reference
+    AppStatus AddImages(const TextureRequest* requests, std::vector<Image>& images, int count);
+    void UnloadTextureData(const Texture2D& texture);
+
+    //Dictionary to store loaded textures and how many users each one has
     std::unordered_map<Resource, Texture2D> textures;
+    std::unordered_map<Resource, int> references;
+
+    //Copies for the software renderer by texture id
+    std::unordered_map<unsigned int, Image> images;
+    bool keep_images;
+
+    //Textures being decoded by PreloadTextures() and the ones already created
+    std::vector<TextureRequest> preload_requests;
+    std::vector<Image> preload_images;
+    JobCounter preload_jobs;
+    std::vector<Resource> preloaded;
+
+    //Worlds may load their textures from different threads
+    mutable std::mutex lock;
+    bool headless;
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "RewindBuffer.h"
+
+//Lengths are written 7 bits per byte, the high bit flags that more bytes follow
+static void WriteLength(std::vector<unsigned char>& out, size_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+static size_t ReadLength(const std::vector<unsigned char>& in, size_t& offset)
+{
+	size_t value = 0;
+	int shift = 0;
+	while (offset < in.size())
+	{
+		unsigned char b = in[offset++];
+		value |= (size_t)(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) break;
+		shift += 7;
+	}
+	return value;
+}
+RewindBuffer::RewindBuffer()
+{
+	groups.resize(REWIND_GROUPS);
+	for (Group& group : groups)
+	{
+		group.deltas.reserve(REWIND_KEYFRAME_INTERVAL);
+		group.delta_count = 0;
+	}
+	first = 0;
+	group_count = 0;
+	count = 0;
+	memory = 0;
+}
+RewindBuffer::~RewindBuffer()
+{
+}
+void RewindBuffer::Clear()
+{
+	//The buffers keep their memory for the next recording
+	first = 0;
+	group_count = 0;
+	count = 0;
+	memory = 0;
+}
+RewindBuffer::Group& RewindBuffer::Oldest()
+{
+	return groups[first];
+}
+RewindBuffer::Group& RewindBuffer::Newest()
+{
+	return groups[(first + group_count - 1) % REWIND_GROUPS];
+}
+void RewindBuffer::DropOldest()
+{
+	Group& group = Oldest();
+	memory -= group.keyframe.size();
+	for (int i = 0; i < group.delta_count; ++i) memory -= group.deltas[i].size();
+	count -= 1 + group.delta_count;
+	first = (first + 1) % REWIND_GROUPS;
+	group_count--;
+}
+void RewindBuffer::Push(const std::vector<unsigned char>& snapshot)
+{
+	if (group_count == 0 || Newest().delta_count + 1 >= REWIND_KEYFRAME_INTERVAL)
+	{
+		if (group_count == REWIND_GROUPS) DropOldest();
+		group_count++;
+		Group& group = Newest();
+		group.keyframe.assign(snapshot.begin(), snapshot.end());
+		group.delta_count = 0;
+		memory += snapshot.size();
+	}
+	else
+	{
+		Group& group = Newest();
+		if (group.delta_count == (int)group.deltas.size()) group.deltas.emplace_back();
+		std::vector<unsigned char>& delta = group.deltas[group.delta_count++];
+		Encode(group.keyframe, snapshot, delta);
+		memory += delta.size();
+	}
+	count++;
+
+	//Drop the oldest group once the newer ones are enough to fill the buffer
+	while (group_count > 1 && count - 1 - Oldest().delta_count >= REWIND_FRAMES)
+	{
+		DropOldest();
+	}
+}
+bool RewindBuffer::StepBack(std::vector<unsigned char>& snapshot)
+{
+	if (count < 2) return false;
+
+	Group& group = Newest();
+	if (group.delta_count == 0)
+	{
+		memory -= group.keyframe.size();
+		group_count--;
+	}
+	else
+	{
+		memory -= group.deltas[group.delta_count - 1].size();
+		group.delta_count--;
+	}
+	count--;
+
+	const Group& newest = Newest();
+	if (newest.delta_count == 0)	snapshot = newest.keyframe;
+	else							Decode(newest.keyframe, newest.deltas[newest.delta_count - 1], snapshot);
+	return true;
+}
+int RewindBuffer::GetCount() const
+{
+	return count;
+}
+size_t RewindBuffer::GetMemory() const
+{
+	return memory;
+}
+void RewindBuffer::Encode(const std::vector<unsigned char>& base, const std::vector<unsigned char>& snapshot, std::vector<unsigned char>& delta)
+{
+	//Snapshot size, then pairs of (unchanged bytes, changed bytes) followed by the changed bytes XORed with the base
+	//Bytes past the end of the base are XORed with zero
+	delta.clear();
+	WriteLength(delta, snapshot.size());
+
+	size_t size = snapshot.size();
+	size_t i = 0;
+	while (i < size)
+	{
+		size_t start = i;
+		while (i < size && i < base.size() && snapshot[i] == base[i]) i++;
+		size_t same = i - start;
+
+		start = i;
+		while (i < size && !(i < base.size() && snapshot[i] == base[i])) i++;
+		size_t changed = i - start;
+
+		WriteLength(delta, same);
+		WriteLength(delta, changed);
+		for (size_t k = start; k < i; ++k)
+		{
+			delta.push_back(snapshot[k] ^ (k < base.size() ? base[k] : 0));
+		}
+	}
+}
+void RewindBuffer::Decode(const std::vector<unsigned char>& base, const std::vector<unsigned char>& delta, std::vector<unsigned char>& snapshot)
+{
+	size_t offset = 0;
+	size_t size = ReadLength(delta, offset);
+	snapshot.resize(size);
+
+	size_t i = 0;
+	while (i < size && offset < delta.size())
+	{
+		size_t same = ReadLength(delta, offset);
+		size_t changed = ReadLength(delta, offset);
+		for (size_t k = 0; k < same && i < size; ++k, ++i)
+		{
+			snapshot[i] = base[i];
+		}
+		for (size_t k = 0; k < changed && i < size && offset < delta.size(); ++k, ++i)
+		{
+			snapshot[i] = delta[offset++] ^ (i < base.size() ? base[i] : 0);
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Globals.h"
+
+//Frames kept by the rewind buffer, one per tick
+#define REWIND_FRAMES				TIME_TO_TICKS(20.0)
+
+//Every this number of frames a full snapshot is stored, the rest are deltas against it
+#define REWIND_KEYFRAME_INTERVAL	TIME_TO_PERIOD(1.0)
+
+//Groups in the ring, enough for REWIND_FRAMES plus the group being filled
+#define REWIND_GROUPS				(REWIND_FRAMES / REWIND_KEYFRAME_INTERVAL + 3)
+
+//Ring of the last game state snapshots. Each frame is stored as the run-length encoded XOR
+//against the keyframe of its group, consecutive snapshots differ in a few bytes so a delta
+//takes tens of bytes. Groups are dropped whole from the oldest end, so a delta never outlives
+//its keyframe. The buffers of dropped frames are reused, so once the ring is full recording
+//a frame doesn't allocate.
+class RewindBuffer
+{
+public:
+    RewindBuffer();
+    ~RewindBuffer();
+
+    void Clear();
+
+    //Store the snapshot of the frame that has just been simulated
+    void Push(const std::vector<unsigned char>& snapshot);
+
+    //Drop the newest frame and rebuild the one before it in 'snapshot', which becomes the newest
+    //Returns false when there is no earlier frame
+    bool StepBack(std::vector<unsigned char>& snapshot);
+
+    int GetCount() const;
+    //Bytes used by the stored frames
+    size_t GetMemory() const;
+
+private:
+    struct Group
+    {
+        std::vector<unsigned char> keyframe;
+        //Encoded deltas of the frames that follow the keyframe, the first 'delta_count' are in use
+        std::vector<std::vector<unsigned char>> deltas;
+        int delta_count;
+    };
+
+    Group& Oldest();
+    Group& Newest();
+    void DropOldest();
+
+    static void Encode(const std::vector<unsigned char>& base, const std::vector<unsigned char>& snapshot, std::vector<unsigned char>& delta);
+    static void Decode(const std::vector<unsigned char>& base, const std::vector<unsigned char>& delta, std::vector<unsigned char>& snapshot);
+
+    //Ring of REWIND_GROUPS groups, 'group_count' of them in use from 'first'
+    std::vector<Group> groups;
+    int first;
+    int group_count;
+    int count;
+    size_t memory;
+};
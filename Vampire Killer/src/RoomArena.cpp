@@ -0,0 +1,79 @@
+#include "RoomArena.h"
+#include <string.h>
+
+RoomArena::RoomArena()
+{
+	block = 0;
+	offset = 0;
+	used = 0;
+	generation = 1;
+}
+RoomArena::~RoomArena()
+{
+}
+void* RoomArena::Allocate(size_t size, size_t alignment)
+{
+	if (alignment < alignof(Header)) alignment = alignof(Header);
+
+	//The header goes right before the aligned start of the object
+	size_t start = (offset + sizeof(Header) + alignment - 1) & ~(alignment - 1);
+	if (blocks.empty() || start + size > blocks[block].size())
+	{
+		//Next block, a new one when every block is in use or the next one is too small
+		if (!blocks.empty()) block++;
+		size_t needed = size + sizeof(Header) + alignment;
+		while (block < (int)blocks.size() && blocks[block].size() < needed) block++;
+		if (block == (int)blocks.size())
+		{
+			blocks.emplace_back(needed > ROOM_ARENA_BLOCK_SIZE ? needed : ROOM_ARENA_BLOCK_SIZE);
+		}
+		offset = 0;
+		start = (sizeof(Header) + alignment - 1) & ~(alignment - 1);
+	}
+	unsigned char* memory = blocks[block].data();
+	Header* header = (Header*)(memory + start - sizeof(Header));
+	header->generation = generation;
+	header->size = (unsigned int)size;
+
+	used += start + size - offset;
+	offset = start + size;
+	return memory + start;
+}
+void RoomArena::Reset()
+{
+#if defined(_DEBUG)
+	//Anything still pointing into the released memory reads garbage instead of a valid object
+	for (int i = 0; i <= block && i < (int)blocks.size(); ++i)
+	{
+		size_t size = i < block ? blocks[i].size() : offset;
+		memset(blocks[i].data(), ROOM_ARENA_POISON, size);
+	}
+#endif
+	block = 0;
+	offset = 0;
+	used = 0;
+	generation++;
+}
+bool RoomArena::IsLive(const void* ptr) const
+{
+	const unsigned char* p = (const unsigned char*)ptr;
+	for (int i = 0; i <= block && i < (int)blocks.size(); ++i)
+	{
+		const unsigned char* memory = blocks[i].data();
+		size_t end = i < block ? blocks[i].size() : offset;
+		if (p >= memory + sizeof(Header) && p < memory + end)
+		{
+			const Header* header = (const Header*)(p - sizeof(Header));
+			return header->generation == generation;
+		}
+	}
+	return false;
+}
+size_t RoomArena::GetUsed() const
+{
+	return used;
+}
+int RoomArena::GetBlockCount() const
+{
+	return (int)blocks.size();
+}
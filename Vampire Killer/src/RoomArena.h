@@ -0,0 +1,57 @@
+#pragma once
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+//Memory of each block of a room arena, a room that needs more adds blocks of the same size
+#define ROOM_ARENA_BLOCK_SIZE	(64 * 1024)
+
+//Pointers freed by Reset() are overwritten with this byte in debug builds
+#define ROOM_ARENA_POISON		0xDD
+
+//Memory for the objects that live until the player leaves the room. Objects are constructed in
+//place by Create() and Reset() releases all of them at once by moving the pointer back to the
+//start; the blocks are kept, so once the largest room has been visited spawning doesn't allocate.
+//The owner calls the destructors before Reset(), the arena only handles the memory.
+class RoomArena
+{
+public:
+	RoomArena();
+	~RoomArena();
+
+	void* Allocate(size_t size, size_t alignment);
+
+	template<class T, class... Args>
+	T* Create(Args&&... args)
+	{
+		return ::new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	//Release every allocation, the objects must have been destroyed already
+	void Reset();
+
+	//Whether 'ptr' was returned by Allocate() since the last Reset(). A pointer kept from a
+	//previous room fails, unless a new object has been placed at the very same address.
+	bool IsLive(const void* ptr) const;
+
+	//Bytes used since the last Reset() and the blocks allocated so far
+	size_t GetUsed() const;
+	int GetBlockCount() const;
+
+private:
+	//Stored right before every allocation
+	struct Header
+	{
+		unsigned int generation;
+		unsigned int size;
+	};
+
+	std::vector<std::vector<unsigned char>> blocks;
+	int block;
+	size_t offset;
+	size_t used;
+
+	//Incremented by every Reset()
+	unsigned int generation;
+};
@@ -2,8 +2,42 @@
 #include <stdio.h>
 #include "Globals.h"
 #include "EnemyManager.h"
-
-Scene::Scene()
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "Snapshot.h"
+#include "RenderQueue.h"
+#include "MemTracker.h"
+#include "ResourceBudget.h"
+#include "FixedMath.h"
+#include <algorithm>
+#include <string.h>
+#include <chrono>
+
+//Textures of the scene, the player, the enemies and the HUD
+static const TextureRequest scene_textures[] = {
+	{ Resource::IMG_PLAYER, "images/Spritesheets/Simon/Simon Spritesheet.png" },
+	{ Resource::IMG_WEAPON, "images/Spritesheets/Simon/WhipChainAttacks.png" },
+	{ Resource::IMG_TILES, "images/Levels/LevelsTileset.png" },
+	{ Resource::IMG_GAME_OVER, "images/Spritesheets/HUD Spritesheet/GameOver.png" },
+	{ Resource::IMG_HUD, "images/Spritesheets/HUD Spritesheet/EmptyHUD.png" },
+	{ Resource::IMG_HUD_ITEMS, "images/Spritesheets/HUD Spritesheet/Items.png" },
+	{ Resource::IMG_OPEN_CHEST, "images/Spritesheets/FX/OpenChest.png" },
+	{ Resource::IMG_POPUP_TRADER, "images/Spritesheets/Enemies & Characters/PopUp.png" },
+	{ Resource::IMG_HIT_EFFECT, "images/Spritesheets/FX/HitFx.png" },
+	{ Resource::IMG_FONT, "images/Spritesheets/HUD Spritesheet/Font.png" },
+	{ Resource::IMG_DOOR, "images/Spritesheets/FX/DoorSprite.png" },
+	{ Resource::IMG_ZOMBIE, "images/Spritesheets/Enemies & Characters/Enemy 1 Sprite Sheet.png" },
+	{ Resource::IMG_PANTHER, "images/Spritesheets/Enemies & Characters/Enemy 4 Sprite Sheet.png" },
+	{ Resource::IMG_BAT, "images/Spritesheets/Enemies & Characters/Enemy 3 Sprite Sheet.png" },
+	{ Resource::IMG_TRADER, "images/Spritesheets/Enemies & Characters/Trader Sprite Sheet.png" },
+	{ Resource::IMG_BOSS, "images/Spritesheets/Enemies & Characters/Boss 1 Sprite Sheet.png" }
+};
+
+void Scene::PreloadTextures()
+{
+	ResourceManager::Instance().PreloadTextures(scene_textures, sizeof(scene_textures) / sizeof(scene_textures[0]));
+}
+Scene::Scene(World* world) : world(world)
 {
 	player = nullptr;
     level = nullptr;
@@ -13,6 +47,7 @@ Scene::Scene()
 
 	currentLevel = 0;
 	currentFloor = 0;
+	activeObjects = &roomObjects[0][0];
 	camera.target = { 0, 0 };				//Center of the screen
 	camera.offset = { SIDE_MARGINS, TOP_MARGIN };	//Offset from the target (center of the screen)
 	camera.rotation = 0.0f;					//No rotation
@@ -28,12 +63,30 @@ Scene::Scene()
 
 	debug = DebugMode::OFF;
 
-	chest_time = 60;
+	enemy_killed_pos = { 0, 0 };
+
+	chest_time = CHEST_OPEN_TIME;
+	chestOpening = false;
+	currentChestX = 0;
+	currentChestY = 0;
+	currentChestType = ObjectType::CHAIN;
 	loot_time = 1;
-	zombie_delay_time = 120;
-	bat_delay_time = 120*2;
+	lootOpening = false;
+	currentLootX = 0;
+	currentLootY = 0;
+	currentLootType = ObjectType::CHAIN;
+	spawnY = 0;
+	loot_carry = 0;
+	zombie_delay_time = ZOMBIE_SPAWN_TIME;
+	bat_delay_time = BAT_SPAWN_TIME;
 
 	bossDoor = new Door({ 15 * TILE_SIZE+8, 2 * TILE_SIZE + 48 });
+
+	hudTarget = {};
+	hudValues = {};
+	hudValid = false;
+	hudRebuilds = 0;
+	playTicks = 0;
 }
 Scene::~Scene()
 {
@@ -55,10 +108,7 @@ Scene::~Scene()
         delete level;
         level = nullptr;
     }
-	for (Entity* obj : objects)
-	{
-		delete obj;
-	}
+	ClearLevel();
 	if (font != nullptr)
 	{
 		delete font;
@@ -70,8 +120,8 @@ AppStatus Scene::Init()
 	ResourceManager& data = ResourceManager::Instance();
 
 	//Create player
-	player = new Player({ 20,144 }, State::IDLE, Look::RIGHT);
-	EnemyManager::Instance().target = player;
+	player = new Player({ 20,144 }, State::IDLE, Look::RIGHT, world);
+	world->enemies.target = player;
 	if (player == nullptr)
 	{
 		LOG("Failed to allocate memory for Player");
@@ -105,7 +155,7 @@ AppStatus Scene::Init()
 	}
 	//Assign the tile map reference to the player to check collisions while navigating
 	player->SetTileMap(level);
-	EnemyManager::Instance().SetTilemap(level);
+	world->enemies.SetTilemap(level);
 
 	//Add the Game Over image for the end
 	if (data.LoadTexture(Resource::IMG_GAME_OVER, "images/Spritesheets/HUD Spritesheet/GameOver.png") != AppStatus::OK)
@@ -126,6 +176,19 @@ AppStatus Scene::Init()
 		return AppStatus::ERROR;
 	}
 	hud_items = data.GetTexture(Resource::IMG_HUD_ITEMS);
+	//Without a window there is no render texture, the HUD is drawn with the rest of the frame
+	if (!data.IsHeadless())
+	{
+		hudTarget = LoadRenderTexture(hud->width, hud->height);
+		if (hudTarget.id == 0)
+		{
+			LOG("Failed to create the HUD render texture");
+			return AppStatus::ERROR;
+		}
+	}
+	hudValid = false;
+	hudRebuilds = 0;
+	playTicks = 0;
 
 	//Add the chest animation
 	if (data.LoadTexture(Resource::IMG_OPEN_CHEST, "images/Spritesheets/FX/OpenChest.png") != AppStatus::OK)
@@ -155,19 +218,19 @@ AppStatus Scene::Init()
 	}
 	hit_effect = data.GetTexture(Resource::IMG_HIT_EFFECT);
 
-	AudioPlayer::Instance().CreateMusic("audio/Music/02 Vampire Killer.ogg", "VampireKiller");
-	AudioPlayer::Instance().SetMusicLoopStatus("VampireKiller",true);
+	world->audio.CreateMusic("audio/Music/02 Vampire Killer.ogg", "VampireKiller");
+	world->audio.SetMusicLoopStatus("VampireKiller",true);
 
-	AudioPlayer::Instance().CreateMusic("audio/Music/08 Poison Mind.ogg", "BossMusic");
-	AudioPlayer::Instance().SetMusicLoopStatus("BossMusic", true);
+	world->audio.CreateMusic("audio/Music/08 Poison Mind.ogg", "BossMusic");
+	world->audio.SetMusicLoopStatus("BossMusic", true);
 
-	AudioPlayer::Instance().CreateSound("audio/SFX/17.wav", "Collect");
-	AudioPlayer::Instance().CreateSound("audio/SFX/25.wav", "OpenChest");
-	AudioPlayer::Instance().CreateSound("audio/SFX/02.wav", "BreakWalls");
-	AudioPlayer::Instance().CreateSound("audio/SFX/03.wav", "EnterCastle");
-	AudioPlayer::Instance().CreateSound("audio/SFX/01.wav", "GetDoorKey");
-	AudioPlayer::Instance().CreateSound("audio/SFX/12.wav", "GetHeart");
-	AudioPlayer::Instance().CreateSound("audio/SFX/05.wav", "OpenDoor");
+	world->audio.CreateSound("audio/SFX/17.wav", "Collect");
+	world->audio.CreateSound("audio/SFX/25.wav", "OpenChest");
+	world->audio.CreateSound("audio/SFX/02.wav", "BreakWalls");
+	world->audio.CreateSound("audio/SFX/03.wav", "EnterCastle");
+	world->audio.CreateSound("audio/SFX/01.wav", "GetDoorKey");
+	world->audio.CreateSound("audio/SFX/12.wav", "GetHeart");
+	world->audio.CreateSound("audio/SFX/05.wav", "OpenDoor");
 
 	player->weapon->SetWeapon(WeaponType::WHIP);
 
@@ -184,114 +247,116 @@ AppStatus Scene::Init()
 		LOG("Failed to initialise Level");
 		return AppStatus::ERROR;
 	}
+	font->Layout("00", stageRuns[0]);
+	font->Layout("01", stageRuns[1]);
 
 	Object* obj;
 
 	// Level 1 Objects
 	obj = new Object({ 5 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::FIRE, { 1,0 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 13 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::FIRE, { 1,0 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	
 	//Level 2 Objects
 	obj = new Object({ 5 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::FIRE, { 2,0 }, ObjectType::HEART_BIG, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 13 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::FIRE, { 2,0 }, ObjectType::HEART_BIG, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	
 	//Level 3 Objects
 	obj = new Object({ 5 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::FIRE, { 3,0 }, ObjectType::CHAIN, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	
 	//Level 4 Objects
 	obj = new Object({ 8 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,0 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 12 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,0 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	
 	//Level 5 Objects
 	obj = new Object({ 4 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 5,0 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 8 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 5,0 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 12 * TILE_SIZE, 7 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 5,0 }, ObjectType::HEART_BIG, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 10 * TILE_SIZE, 3 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 5,0 }, ObjectType::HEART_BIG, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	
 	//Level 6 Objects
 	obj = new Object({ 7 * TILE_SIZE, 3 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 6,0 }, ObjectType::HEART_SMALL, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 12 * TILE_SIZE, 3 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 6,0 }, ObjectType::HEART_SMALL, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 14 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 6,0 }, ObjectType::HEART_BIG, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 5 * TILE_SIZE, 10 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::KEY_CHEST, { 6,0 });
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 12 * TILE_SIZE, 10 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CHEST_HEART, { 6,0 });
-	objects.push_back(obj);
+	AddObject(obj);
 	
 	//Level 7 Objects
 	obj = new Object({ 12 * TILE_SIZE, 4 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 7,0 }, ObjectType::HEART_BIG, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 5 * TILE_SIZE, 5 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 7,0 }, ObjectType::HEART_BIG, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 3 * TILE_SIZE, 9 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 7,0 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 9 * TILE_SIZE, 9 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 7,0 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 4 * TILE_SIZE, 6 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CHEST_WINGS, { 7,0 });
-	objects.push_back(obj);
+	AddObject(obj);
 
 	//Level 4, floor 1 Objects
 	obj = new Object({ 4 * TILE_SIZE, 1 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,1 }, ObjectType::HEART_BIG, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 4 * TILE_SIZE, 5 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,1 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 12 * TILE_SIZE, 3 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,1 }, ObjectType::HEART_BIG, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 11 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,1 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 7 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 4,1 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 3 * TILE_SIZE, 2 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CHEST_BOOTS, { 4,1 });
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 3 * TILE_SIZE, 6 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CHEST_SHIELD, { 4,1 });
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 3 * TILE_SIZE, 10 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::KEY_CHEST, { 4,1 });
-	objects.push_back(obj);
+	AddObject(obj);
 
 	//Level 5, floor 1 Objects
 	obj = new Object({ 10 * TILE_SIZE, 7 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 5,1 }, ObjectType::HEART_SMALL, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 5 * TILE_SIZE, 8 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 5,1 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 
 	//Level 6, floor 1 Objects
 	obj = new Object({ 8 * TILE_SIZE, 7 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 6,1 }, ObjectType::HEART_SMALL, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 14 * TILE_SIZE, 4 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 6,1 }, ObjectType::HEART_SMALL, 2 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 
 	//Level 7, floor 1 Objects
 	obj = new Object({ 7 * TILE_SIZE, 9 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 7,1 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 11 * TILE_SIZE, 9 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 7,1 }, ObjectType::HEART_SMALL, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 9 * TILE_SIZE, 6 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::KEY_CHEST, { 7,1 });
-	objects.push_back(obj);
+	AddObject(obj);
 
 	//Level 8, floor 1 Objects
 	obj = new Object({ 8 * TILE_SIZE, 7 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 8,1 }, ObjectType::HEART_BIG, 3 * TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 	obj = new Object({ 11 * TILE_SIZE, 7 * TILE_SIZE + TILE_SIZE - 1 }, ObjectType::CANDLE, { 8,1 }, ObjectType::HEART_BIG, TILE_SIZE);
-	objects.push_back(obj);
+	AddObject(obj);
 
     return AppStatus::OK;
 }
 AppStatus Scene::LoadLevel(int stage,int floor)
 {
-	int size;
+	int data_size;
 	int x, y, i;
 	Tile tile;
 	Point pos;
@@ -300,14 +365,15 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 	int *mapFront = nullptr;
 	//Object *obj = nullptr;
 	Object* obj;
+	MemScope scope(MemTag::TILEMAP);
 	
 
-	size = LEVEL_WIDTH * LEVEL_HEIGHT;
+	data_size = LEVEL_WIDTH * LEVEL_HEIGHT;
 	if (stage == 1 && floor == 0)
 	{
 		currentLevel = 1;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  1,  2,  3,  4,  1,  2,  3,  4,  1,  2,  3,  4,  1,  2,  3,  4,  0,
 			  0,  5,  6,  7,  8,  5,  6,  7,  8,  5,  6,  7,  8,  5,  6,  7,  8,  0,
@@ -322,7 +388,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 			};
-		map = new int[size] {
+		map = new int[data_size] {
 			550,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			550,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			550,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -337,7 +403,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -353,7 +419,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
 
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 		if (player->isGUIinit == false) {
 			player->InitGUI();
 		}
@@ -363,7 +429,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 	{
 		currentLevel = 2;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  1,  2,  3,  4,  1,  2,  3,  4,  1,  2,  3,  4,  1,  2,  3,  4,  0,
 			  0,  5,  6,  7,  8,  5,  6,  7,  8,  5,  6,  7,  8,  5,  6,  7,  8,  0,
@@ -378,7 +444,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			 500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			 500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			 500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -393,7 +459,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			   0, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,  0,
 			   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -408,13 +474,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 3 && floor == 0)
 	{
 		currentLevel = 3;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  1,  2,  3,  4,  1,  2,  3,  4,  1,  2, 47, 48, 49, 48, 49, 48,  0,
 			  0,  5,  6,  7,  8,  5,  6,  7,  8,  5,  6, 50, 51, 52, 52, 53, 54,  0,
@@ -429,7 +495,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,  0,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,  0,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,  0,
@@ -444,7 +510,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40, 40,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -459,13 +525,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 4 && floor == 0)
 	{
 		currentLevel = 4;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0, 74, 75, 82, 83,110,110, 97, 98, 74, 75, 86, 87,110,110,101,102,  0,
 			  0, 76, 77, 84, 85,110,110, 99,100, 76, 77, 91,110,110,110,110,110,  0,
@@ -480,7 +546,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -495,7 +561,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -510,13 +576,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 5 && floor == 0)
 	{
 		currentLevel = 5;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0, 74, 75, 82, 83,110,110, 97, 98,110, 93,  0,  0,110,110,101,102,  0,
 			  0, 76, 77, 84, 85,103,103,103,103,110,110,110,  0,  0,110,110,110,  0,
@@ -531,7 +597,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			500,  0,  0,  0,  0,  0,  0,  0,502,502,502,502,502,502,  0,  0,  0,501,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,105,106,  0,  0,  0,  0,501,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,105,106,  0,  0,  0,501,
@@ -546,7 +612,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -561,13 +627,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 6 && floor == 0)
 	{
 		currentLevel = 6;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0, 97, 98, 76, 77, 86, 87,110,110,110,110,110,110,101,102,110,110,  0,
 			  0, 99,100, 76, 77, 91,110,110,110,103,103,110,110,110,110,110,110,  0,
@@ -583,7 +649,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
 		if (!level6WallBroken) {
-			map = new int[size] {
+			map = new int[data_size] {
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -600,7 +666,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			};
 		}
 		else if(level6WallBroken){
-				map = new int[size] {
+				map = new int[data_size] {
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -616,7 +682,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 				  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 			};
 		}
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -631,13 +697,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 7 && floor == 0)
 	{
 		currentLevel = 7;
 		currentFloor = 0;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,101,102,110,110,  0,  0, 93,110,110,110, 97, 98, 74, 75, 82, 83,  0,
 			  0,110,110,110,  0,  0,110,110,110,110,110, 99,100, 76, 77, 84, 85,  0,
@@ -652,7 +718,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			500,  0,  0,  0,502,502,502,502,502,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			500,  0,  0,  0,  0,107,104,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			500,  0,  0,  0,107,104,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -667,7 +733,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -682,13 +748,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 4 && floor == 1)
 	{
 		currentLevel = 4;
 		currentFloor = 1;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,110,110, 74, 75,110,110,110,110,110,110,101,102, 74, 75,  0,
 			  0,  0,  0,110,110, 76, 77,110,110,110,110,110,110, 95, 96, 76, 77,  0,
@@ -703,7 +769,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			  0,550,550,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			  0,108,109,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			  0,108,109,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -718,7 +784,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -733,13 +799,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 5 && floor == 1)
 	{
 		currentLevel = 5;
 		currentFloor = 1;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,110,110, 74, 75, 86, 87,110,110, 97, 98,110,110, 74, 75, 82, 83,  0,
 			  0, 95, 96, 76, 77, 88,110,103,103,103,103,110,110, 76, 77, 84, 85,  0,
@@ -754,7 +820,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,  0,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -769,7 +835,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			500,108,109,108,109,108,109,108,109,108,109,108,106,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,503,503,503,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -784,13 +850,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,551,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 6 && floor == 1)
 	{
 		currentLevel = 6;
 		currentFloor = 1;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,110,110,101,102, 74, 75, 82, 83,110,110, 97, 98,110,110, 97, 98,  0,
 			  0, 95, 96,110,110, 76, 77, 84, 85,110,110,103,103,110,110,103,103,  0,
@@ -805,7 +871,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
 			500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -820,7 +886,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			500,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -835,13 +901,13 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else if (stage == 7 && floor == 1)
 	{
 		currentLevel = 7;
 		currentFloor = 1;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0, 74, 75, 82, 83,110,110, 97, 98,110,110,110,110, 97, 98,  0,  0,  0,
 			  0, 76, 77, 84, 85, 95, 96,103,103,110,110,110,110, 99,100,  0,  0,  0,
@@ -856,10 +922,10 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,  0,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 		
 		if (!level7_1WallBroken) {
-			map = new int[size] {
+			map = new int[data_size] {
 				  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,108,109,501,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -876,7 +942,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			};
 		}
 		else if (level7_1WallBroken) {
-			map = new int[size] {
+			map = new int[data_size] {
 				  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,108,109,501,
 				500,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,501,
@@ -893,7 +959,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			};
 			
 		}
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -908,14 +974,14 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 		
 	}
 	else if (stage == 8 && floor == 1)
 	{
 		currentLevel = 8;
 		currentFloor = 1;
-		mapBack = new int[size] {
+		mapBack = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,111,111, 74, 75,111,113,111,111, 74, 75,111,111,111,111, 74, 75,  0,
 			  0,123,123, 78, 77,123,123,123,123, 76, 77,123,123,123,123, 76, 77,  0,
@@ -930,7 +996,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		map = new int[size] {
+		map = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			550,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,550,
 			550,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,550,
@@ -945,7 +1011,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			550,108,109,108,109,108,109,108,109,108,109,108,109,108,109,108,109,550,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		mapFront = new int[size] {
+		mapFront = new int[data_size] {
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -960,7 +1026,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
 			  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
 		};
-		EnemyManager::Instance().DestroyEnemies();
+		world->enemies.DestroyEnemies();
 	}
 	else
 	{
@@ -968,6 +1034,7 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 		LOG("Failed to load level, stage %d doesn't exist", stage);
 		return AppStatus::ERROR;	
 	}
+	activeObjects = &roomObjects[currentLevel][currentFloor];
 
 	//Player
 	i = 0;
@@ -1037,6 +1104,8 @@ AppStatus Scene::LoadLevel(int stage,int floor)
 	delete[] map;
 	delete[] mapFront;
 	delete[] mapBack;
+
+	world->enemies.CheckRoomMemory();
 	return AppStatus::OK;
 }
 void Scene::Update()
@@ -1044,89 +1113,135 @@ void Scene::Update()
 	Point p1, p2;
 	AABB box;
 	Point left_position(16+3, player->GetPos().y);
+	playTicks++;
 	Point right_position(256-3, player->GetPos().y);
 	Point top_position(player->GetPos().x, 48);
 	Point bottom_position(player->GetPos().x, 150);
 
 	Point boss_position(16 + 3, 170);
 
-	EnemyManager::Instance().SetTilemap(level);
+	world->enemies.SetTilemap(level);
+
+	//Frames rendered before the next tick are drawn between these positions and the new ones
+	player->StorePreviousPos();
+	player->weapon->StorePreviousPos();
+	world->enemies.StorePreviousPositions();
+	for (Object* obj : *activeObjects) obj->StorePreviousPos();
 
 	//Switch between the different debug modes: off, on (sprites & hitboxes), on (hitboxes) 
-	if (IsKeyPressed(KEY_F2))
+	if (world->input.WasKeyPressed(KEY_F2))
 	{
 		debug = (DebugMode)(((int)debug + 1) % (int)DebugMode::SIZE);
 	}
+	//Step back one recorded frame per update while the rewind key is held
+	if (debug != DebugMode::OFF && world->input.IsDown(Button::REWIND))
+	{
+		if (world->input.IsPressed(Button::REWIND)) LOG("Rewind: %d frames in %d KB", rewind.GetCount(), (int)(rewind.GetMemory() / 1024));
+		if (rewind.StepBack(frameState)) LoadState(frameState);
+		return;
+	}
+
 	//Debug levels instantly
 
-	AudioPlayer::Instance().PlayMusicByName("VampireKiller");
+	world->audio.PlayMusicByName("VampireKiller");
 
 	if (debug == DebugMode::SPRITES_AND_HITBOXES || debug == DebugMode::ONLY_HITBOXES) {
-		if (IsKeyPressed(KEY_ONE)) {
+		if (world->input.WasKeyPressed(KEY_ONE)) {
 			player->SetPos({ player->GetPos().x , player->GetPos().y - 16 });
 			LoadLevel(1, 0);
 		}
-		else if (IsKeyPressed(KEY_TWO)) {
+		else if (world->input.WasKeyPressed(KEY_TWO)) {
 			player->SetPos({ player->GetPos().x , player->GetPos().y - 16 });
 			LoadLevel(2, 0);
 		}
-		else if (IsKeyPressed(KEY_THREE)) {
+		else if (world->input.WasKeyPressed(KEY_THREE)) {
 			player->SetPos({ player->GetPos().x , player->GetPos().y - 16 });
 			LoadLevel(3, 0);
 		}
-		else if (IsKeyPressed(KEY_FOUR))	LoadLevel(4,0);
-		else if (IsKeyPressed(KEY_FIVE))	LoadLevel(5,0);
-		else if (IsKeyPressed(KEY_SIX))		LoadLevel(6,0);
-		else if (IsKeyPressed(KEY_SEVEN))	LoadLevel(7,0);
-		else if (IsKeyPressed(KEY_EIGHT))	LoadLevel(4,1);
-		else if (IsKeyPressed(KEY_NINE))	LoadLevel(5,1);
-		else if (IsKeyPressed(KEY_ZERO))	LoadLevel(6,1);
-		else if (IsKeyPressed(KEY_O))	LoadLevel(7,1);
-		else if (IsKeyPressed(KEY_P))	LoadLevel(8,1);
-
-		else if (IsKeyPressed(KEY_C))		player->weapon->SetWeapon(WeaponType::CHAIN);
-		else if (IsKeyPressed(KEY_F3)) {
-			AudioPlayer::Instance().StopMusicByName("VampireKiller");
-			AudioPlayer::Instance().StopMusicByName("BossMusic");
+		else if (world->input.WasKeyPressed(KEY_FOUR))	LoadLevel(4,0);
+		else if (world->input.WasKeyPressed(KEY_FIVE))	LoadLevel(5,0);
+		else if (world->input.WasKeyPressed(KEY_SIX))		LoadLevel(6,0);
+		else if (world->input.WasKeyPressed(KEY_SEVEN))	LoadLevel(7,0);
+		else if (world->input.WasKeyPressed(KEY_EIGHT))	LoadLevel(4,1);
+		else if (world->input.WasKeyPressed(KEY_NINE))	LoadLevel(5,1);
+		else if (world->input.WasKeyPressed(KEY_ZERO))	LoadLevel(6,1);
+		else if (world->input.WasKeyPressed(KEY_O))	LoadLevel(7,1);
+		else if (world->input.WasKeyPressed(KEY_P))	LoadLevel(8,1);
+
+		else if (world->input.WasKeyPressed(KEY_C))		player->weapon->SetWeapon(WeaponType::CHAIN);
+		else if (world->input.WasKeyPressed(KEY_F3)) {
+			world->audio.StopMusicByName("VampireKiller");
+			world->audio.StopMusicByName("BossMusic");
 			player->Win();
 		}
-		else if (IsKeyPressed(KEY_F1))	    player->GodModeSwitch();
-		else if (IsKeyPressed(KEY_F4) || player->GetLife() == 0)
+		else if (world->input.WasKeyPressed(KEY_F1))	    player->GodModeSwitch();
+		else if (world->input.WasKeyPressed(KEY_F4) || player->GetLife() == 0)
 		{
 			if (!player->IsGodMode() && player->GetState() != State::DYING) {
 				player->StartDying();
 			}
 		}
-		else if (IsKeyPressed(KEY_F5))
+		else if (world->input.WasKeyPressed(KEY_F5))
 		{
 			if (!player->IsGodMode()) {
 				player->DecrLife(8);
 			}
 		}
-		else if (IsKeyPressed(KEY_F6)) player->IncrHearts(99);
-		else if (IsKeyPressed(KEY_G)) {
-			EnemyManager::Instance().SpawnZombie(player->GetPos());
+		else if (world->input.WasKeyPressed(KEY_F6)) player->IncrHearts(99);
+		else if (world->input.WasKeyPressed(KEY_G)) {
+			world->enemies.SpawnZombie(player->GetPos());
 		}
-		else if (IsKeyPressed(KEY_H)) {
-			EnemyManager::Instance().SpawnBat(player->GetPos());
+		else if (world->input.WasKeyPressed(KEY_H)) {
+			world->enemies.SpawnBat(player->GetPos());
 		}
-		else if (IsKeyPressed(KEY_J)) {
-			EnemyManager::Instance().SpawnBoss(player->GetPos());
+		else if (world->input.WasKeyPressed(KEY_J)) {
+			world->enemies.SpawnBoss(player->GetPos());
 		}
-		else if (IsKeyPressed(KEY_K)) {
-			EnemyManager::Instance().SpawnTrader(player->GetPos());
+		else if (world->input.WasKeyPressed(KEY_K)) {
+			world->enemies.SpawnTrader(player->GetPos());
 		}
-		else if (IsKeyPressed(KEY_L)) {
+		else if (world->input.WasKeyPressed(KEY_L)) {
 			Object* obj;
 			obj = new Object(player->GetPos(), ObjectType::SHIELD, {(float)currentLevel, (float)currentFloor});
-			objects.push_back(obj);
+			AddObject(obj);
+		}
+		else if (world->input.WasKeyPressed(KEY_B))	RunBroadphaseBenchmark();
+		else if (world->input.WasKeyPressed(KEY_N))	RunAABBBatchBenchmark();
+		else if (world->input.WasKeyPressed(KEY_M))	ResourceBudget::Instance().Dump();
+		else if (world->input.WasKeyPressed(KEY_E)) {
+			if (world->events.IsRecording()) {
+				world->events.StopRecording();
+				world->events.SaveRecording("events.log");
+			}
+			else {
+				world->events.StartRecording();
+			}
+		}
+		else if (world->input.WasKeyPressed(KEY_F7)) {
+			auto start = std::chrono::high_resolution_clock::now();
+			SaveState(quickSave);
+			std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+			LOG("Quick save: %d bytes in %.1f us", (int)quickSave.size(), elapsed.count());
+			SaveSnapshotFile(QUICKSAVE_FILE, quickSave);
+		}
+		else if (world->input.WasKeyPressed(KEY_F8)) {
+			if (!quickSave.empty() || LoadSnapshotFile(QUICKSAVE_FILE, quickSave) == AppStatus::OK) {
+				auto start = std::chrono::high_resolution_clock::now();
+				AppStatus status = LoadState(quickSave);
+				std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+				if (status == AppStatus::OK) {
+					LOG("Quick load: %d bytes in %.1f us", (int)quickSave.size(), elapsed.count());
+				}
+				else {
+					//Read the file again on the next try instead of the rejected snapshot
+					quickSave.clear();
+				}
+			}
 		}
 	}
 
 	box = player->GetHitbox();
 
-	AudioPlayer::Instance().Update();
-
 	if (level->TestCollisionRight(box))
 	{
 		if (currentLevel == 7 && currentFloor == 1)
@@ -1139,7 +1254,7 @@ void Scene::Update()
 			player->SetPos(left_position);
 		}
 		else if (currentLevel == 3) {
-			AudioPlayer::Instance().PlaySoundByName("EnterCastle");
+			world->audio.PlaySoundByName("EnterCastle");
 			LoadLevel(currentLevel + 1, currentFloor);
 			player->SetPos(left_position);
 		}
@@ -1173,12 +1288,12 @@ void Scene::Update()
 	}
 
 	if (level->TestCollisionWin(box)) {
-		AudioPlayer::Instance().StopMusicByName("VampireKiller");
-		AudioPlayer::Instance().StopMusicByName("BossMusic");
+		world->audio.StopMusicByName("VampireKiller");
+		world->audio.StopMusicByName("BossMusic");
 		player->Win();
 	}
 
-	EnemyManager::Instance().SetTilemap(level);
+	world->enemies.SetTilemap(level);
 	
 	Object* obj;
 	if (chestOpening) {
@@ -1187,36 +1302,36 @@ void Scene::Update()
 		if (chest_time == 0) {
 			if (currentChestType == ObjectType::CHEST_CHAIN) {
 				obj = new Object({ (int)currentChestX,(int)currentChestY }, ObjectType::CHAIN, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
-				chest_time = 60;
+				AddObject(obj);
+				chest_time = CHEST_OPEN_TIME;
 				chestOpening = false;
 			}
 			if (currentChestType == ObjectType::CHEST_SHIELD) {
 
 				obj = new Object({ (int)currentChestX,(int)currentChestY }, ObjectType::SHIELD, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
-				chest_time = 60;
+				AddObject(obj);
+				chest_time = CHEST_OPEN_TIME;
 				chestOpening = false;
 			}
 			if (currentChestType == ObjectType::CHEST_BOOTS) {
 
 				obj = new Object({ (int)currentChestX,(int)currentChestY }, ObjectType::BOOTS, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
-				chest_time = 60;
+				AddObject(obj);
+				chest_time = CHEST_OPEN_TIME;
 				chestOpening = false;
 			}
 			if (currentChestType == ObjectType::CHEST_WINGS) {
 
 				obj = new Object({ (int)currentChestX,(int)currentChestY }, ObjectType::WINGS, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
-				chest_time = 60;
+				AddObject(obj);
+				chest_time = CHEST_OPEN_TIME;
 				chestOpening = false;
 			}
 			if (currentChestType == ObjectType::CHEST_HEART) {
 
 				obj = new Object({ (int)currentChestX,(int)currentChestY }, ObjectType::HEART_BIG, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
-				chest_time = 60;
+				AddObject(obj);
+				chest_time = CHEST_OPEN_TIME;
 				chestOpening = false;
 			}
 		}
@@ -1224,26 +1339,26 @@ void Scene::Update()
 
 	if (lootOpening) {
 		loot_time--;
-		spawnY++;
+		spawnY += FixedStep(LOOT_FALL_SPEED, loot_carry);
 
 		if (loot_time < 0) {
 			if (currentLootType == ObjectType::CHAIN) {
 				obj = new Object({ (int)currentLootX,(int)spawnY }, ObjectType::CHAIN, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
+				AddObject(obj);
 				lootOpening = false;
-				loot_time = 40;
+				loot_time = LOOT_DROP_TIME;
 			}
 			if (currentLootType == ObjectType::HEART_BIG) {
 				obj = new Object({ (int)currentLootX,(int)spawnY }, ObjectType::HEART_BIG, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
+				AddObject(obj);
 				lootOpening = false;
-				loot_time = 40;
+				loot_time = LOOT_DROP_TIME;
 			}
 			if (currentLootType == ObjectType::HEART_SMALL) {
 				obj = new Object({ (int)currentLootX,(int)spawnY }, ObjectType::HEART_SMALL, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
+				AddObject(obj);
 				lootOpening = false;
-				loot_time = 40;
+				loot_time = LOOT_DROP_TIME;
 			}
 		}
 	}
@@ -1252,14 +1367,14 @@ void Scene::Update()
 	if (zombie_delay_time < 0) {
 		if (currentFloor == 0) {
 			if (currentLevel == 4 || currentLevel == 5 ) {
-				EnemyManager::Instance().SpawnZombie({ 236,175 });
-				zombie_delay_time = 120;
+				world->enemies.SpawnZombie({ 236,175 });
+				zombie_delay_time = ZOMBIE_SPAWN_TIME;
 			}
 		}
 		if (currentFloor == 1) {
 			if (currentLevel == 5 || currentLevel == 6) {
-				EnemyManager::Instance().SpawnZombie({ 236,175 });
-				zombie_delay_time = 120;
+				world->enemies.SpawnZombie({ 236,175 });
+				zombie_delay_time = ZOMBIE_SPAWN_TIME;
 			}
 		}
 	}
@@ -1267,48 +1382,33 @@ void Scene::Update()
 	bat_delay_time--;
 	if (bat_delay_time < 0) {
 		if (currentFloor == 1 && currentLevel == 4) {
-			EnemyManager::Instance().SpawnBat({ 236,player->GetPos().y });
-			bat_delay_time = 120*2;
+			world->enemies.SpawnBat({ 236,player->GetPos().y });
+			bat_delay_time = BAT_SPAWN_TIME;
 		}
 	}
 
 	if (player->weapon->GetFrame() == 2) {
-		if (currentLevel == 6 && currentFloor == 0) {
+		if ((currentLevel == 6 && currentFloor == 0) || (currentLevel == 7 && currentFloor == 1)) {
 			if (level->TestCollisionBreakableBrick(player->weapon->HitboxOnAttack())) {	
-				level->TurnIntoAir();
-				obj = new Object({ 144,160 }, ObjectType::KEY_DOOR, { 6, 0 });
-				objects.push_back(obj);
-				level6WallBroken = true;
-				AudioPlayer::Instance().PlaySoundByName("BreakWalls");
-			}
-		}
-		else if (currentLevel == 7 && currentFloor == 1) {
-			if (level->TestCollisionBreakableBrick(player->weapon->HitboxOnAttack())) {
-				level->TurnIntoAir();
-				level7_1WallBroken = true;
-				if (!traderSpawned) {
-					EnemyManager::Instance().SpawnTrader({ 205,175 });
-					traderSpawned = true;
-				}
-				AudioPlayer::Instance().PlaySoundByName("BreakWalls");
+				world->events.Push(EventType::WALL_BROKEN, player->weapon->HitboxOnAttack().pos, 0);
 			}
 		}
 	}
 
-	if (currentLevel == 8 && EnemyManager::Instance().IsBossDead()) {
+	if (currentLevel == 8 && world->enemies.IsBossDead()) {
 		boss_loot_time--;
-		bossSpawnY++;
+		bossSpawnY += FixedStep(LOOT_FALL_SPEED, boss_loot_carry);
 		if (boss_loot_time < 0) {
 			if (!boss_loot_spawned) {
 				obj = new Object({ WINDOW_WIDTH/2,(int)bossSpawnY }, ObjectType::BOSS_BALL, { (float)currentLevel, (float)currentFloor });
-				objects.push_back(obj);
+				AddObject(obj);
 				boss_loot_spawned = true;
 			}
 		}
 	}
 
 	if (currentLevel == 8 && !boss_spawned) {
-		EnemyManager::Instance().SpawnBoss({ 100, 100 });
+		world->enemies.SpawnBoss({ 100, 100 });
 		boss_spawned = true;
 	}
 
@@ -1316,28 +1416,28 @@ void Scene::Update()
 		boot_time--;
 		if (boot_time <= 0) {
 			gotBoots = false;
-			boot_time = 60;
+			boot_time = ITEM_MESSAGE_TIME;
 		}
 	}
 	if (gotWings == true) {
 		wings_time--;
 		if (wings_time <= 0) {
 			gotWings = false;
-			wings_time = 60;
+			wings_time = ITEM_MESSAGE_TIME;
 		}
 	}
 	if (gotShield == true) {
 		shield_time--;
 		if (shield_time <= 0) {
 			gotShield = false;
-			shield_time = 60;
+			shield_time = ITEM_MESSAGE_TIME;
 		}
 	}
 	if (gotHeart == true) {
 		heart_time--;
 		if (heart_time <= 0) {
 			gotHeart = false;
-			heart_time = 60;
+			heart_time = ITEM_MESSAGE_TIME;
 		}
 	}
 
@@ -1345,7 +1445,7 @@ void Scene::Update()
 		if (player->GetHitbox().TestAABB(bossDoor->GetHitbox())) {
 			if (player->HasDoorKey()) {
 				bossDoor->Open();
-				AudioPlayer::Instance().PlaySoundByName("OpenDoor");
+				world->audio.PlaySoundByName("OpenDoor");
 			}
 			else {
 				player->SetPos({ player->GetPos().x-1, player->GetPos().y });
@@ -1354,52 +1454,88 @@ void Scene::Update()
 	}
 
 	if (currentLevel == 8 && currentFloor == 1) {
-		if (AudioPlayer::Instance().IsMusicPlaying("VampireKiller")) {
-			AudioPlayer::Instance().StopMusicByName("VampireKiller");
-			AudioPlayer::Instance().PlayMusicByName("BossMusic");
+		if (world->audio.IsMusicPlaying("VampireKiller")) {
+			world->audio.StopMusicByName("VampireKiller");
+			world->audio.PlayMusicByName("BossMusic");
 		}
 	}
 	else {
-		if (AudioPlayer::Instance().IsMusicPlaying("BossMusic")) {
-			AudioPlayer::Instance().StopMusicByName("BossMusic");
-			AudioPlayer::Instance().PlayMusicByName("VampireKiller");
+		if (world->audio.IsMusicPlaying("BossMusic")) {
+			world->audio.StopMusicByName("BossMusic");
+			world->audio.PlayMusicByName("VampireKiller");
 		}
 	}
 
 	bossDoor->Update();
 	level->Update();
-	EnemyManager::Instance().SetTilemap(level);
-	EnemyManager::Instance().Update();
+	world->enemies.SetTilemap(level);
+	world->enemies.Update();
 	player->Update();
-	for (Object* obj : objects)
+	std::vector<Object*>& objects = *activeObjects;
+	JobSystem::Instance().ParallelFor((int)objects.size(), OBJECT_UPDATE_GRAIN, [&objects](int begin, int end) {
+		for (int i = begin; i < end; ++i)
+		{
+			objects[i]->Update();
+		}
+	});
+	BuildBroadphase();
+	CheckCollisions();
+	ProcessEvents();
+
+	//The trader popup stays hidden once the trader has been hit
+	if (world->enemies.DeleteTraderPopUp()) {
+		DeletePopUp();
+	}
+
+	//Respawn or game over once the dying animation has finished
+	HandleDeath();
+
+	if (recordRewind)
 	{
-		obj->Update();
+		SaveState(frameState);
+		rewind.Push(frameState);
 	}
-	CheckCollisions();
+}
+unsigned long long Scene::GetStateHash()
+{
+	SaveState(frameState);
+	return HashSnapshot(frameState);
+}
+void Scene::EnableRewind(bool enable)
+{
+	recordRewind = enable;
+	if (!enable) rewind.Clear();
 }
 void Scene::Render()
 {
-	BeginMode2D(camera);
+	RenderQueue& queue = RenderQueue::Instance();
+
+	queue.BeginCamera(camera);
 	if (!player->IsDead()) {
+		queue.SetLayer(RenderLayer::BACKGROUND);
 		level->RenderEarly();
 
+		queue.SetLayer(RenderLayer::TILES);
 		level->Render();
 		if (debug == DebugMode::OFF || debug == DebugMode::SPRITES_AND_HITBOXES)
 		{
+			queue.SetLayer(RenderLayer::OBJECTS);
 			RenderObjects(); 
-			EnemyManager::Instance().Render();
+			queue.SetLayer(RenderLayer::ENEMIES);
+			world->enemies.Render();
+			queue.SetLayer(RenderLayer::ITEMS);
 			if (chestOpening) {
-				if (chest_time % 30 < 8) {
-					DrawTextureRec(*chest_animation, { 0,0,16,16 }, { currentChestX, currentChestY-16 }, WHITE);
+				if (chest_time % LOOT_ANIM_PERIOD < TIME_TO_TICKS(0.133)) {
+					queue.PushTextureRec(*chest_animation, { 0,0,16,16 }, { currentChestX, currentChestY-16 }, WHITE);
 				}
-				else if (chest_time % 30 < 16) {
-					DrawTextureRec(*chest_animation, { 16 * 1,0,16,16 }, { currentChestX, currentChestY-16  }, WHITE);
+				else if (chest_time % LOOT_ANIM_PERIOD < TIME_TO_TICKS(0.267)) {
+					queue.PushTextureRec(*chest_animation, { 16 * 1,0,16,16 }, { currentChestX, currentChestY-16  }, WHITE);
 				}
-				else if (chest_time % 30 < 23) {
-					DrawTextureRec(*chest_animation, { 16 * 2,0,16,16 }, { currentChestX, currentChestY-16  }, WHITE);
+				else if (chest_time % LOOT_ANIM_PERIOD < TIME_TO_TICKS(0.383)) {
+					queue.PushTextureRec(*chest_animation, { 16 * 2,0,16,16 }, { currentChestX, currentChestY-16  }, WHITE);
 				}
-				else if (chest_time % 30 < 30) {
-					DrawTextureRec(*chest_animation, { 16 * 3,0,16,16 }, { currentChestX, currentChestY-16  }, WHITE);
+				else if (chest_time % LOOT_ANIM_PERIOD < LOOT_ANIM_PERIOD) {
+					queue.PushTextureRec(*chest_animation, { 16 * 3,0,16,16 }, { currentChestX, currentChestY-16  }, WHITE);
 				}
 			}
 
@@ -1409,40 +1545,40 @@ void Scene::Render()
 
 			if (lootOpening) {		
 				if (currentLootType == ObjectType::CHAIN) {
-					if ((int)loot_time % 30 < 8) {
-						DrawTextureRec(*chest_animation, { 0,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
+					if ((int)loot_time % LOOT_ANIM_PERIOD < TIME_TO_TICKS(0.133)) {
+						queue.PushTextureRec(*chest_animation, { 0,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
 					}
-					else if ((int)loot_time % 30 < 16) {
-						DrawTextureRec(*chest_animation, { 16 * 1,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
+					else if ((int)loot_time % LOOT_ANIM_PERIOD < TIME_TO_TICKS(0.267)) {
+						queue.PushTextureRec(*chest_animation, { 16 * 1,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
 					}
-					else if ((int)loot_time % 30 < 23) {
-						DrawTextureRec(*chest_animation, { 16 * 2,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
+					else if ((int)loot_time % LOOT_ANIM_PERIOD < TIME_TO_TICKS(0.383)) {
+						queue.PushTextureRec(*chest_animation, { 16 * 2,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
 					}
-					else if ((int)loot_time % 30 < 30) {
-						DrawTextureRec(*chest_animation, { 16 * 3,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
+					else if ((int)loot_time % LOOT_ANIM_PERIOD < LOOT_ANIM_PERIOD) {
+						queue.PushTextureRec(*chest_animation, { 16 * 3,0,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
 					}
 				}
 				else {
-					DrawTextureRec(*loot_heart, { 14*16,4*16,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
+					queue.PushTextureRec(*loot_heart, { 14*16,4*16,16,16 }, { currentLootX, spawnY - 16 }, WHITE);
 				}
 			}
 
 			if (currentLevel == 8) {
-				if (EnemyManager::Instance().IsBossDead()) {
-					if (boss_loot_time % 30 > 15 && boss_loot_time > 0) {
-						DrawTextureRec(*loot_heart, { 1 * 16,8 * 16,16,16 }, { WINDOW_WIDTH / 2, bossSpawnY - 16 }, WHITE);
+				if (world->enemies.IsBossDead()) {
+					if (boss_loot_time % BOSS_LOOT_BLINK > BOSS_LOOT_BLINK / 2 && boss_loot_time > 0) {
+						queue.PushTextureRec(*loot_heart, { 1 * 16,8 * 16,16,16 }, { WINDOW_WIDTH / 2, bossSpawnY - 16 }, WHITE);
 					}
-					else if (boss_loot_time % 30 < 15 && boss_loot_time > 0) {
-						DrawTextureRec(*loot_heart, { 2 * 16,8 * 16,16,16 }, { WINDOW_WIDTH / 2, bossSpawnY - 16 }, WHITE);
+					else if (boss_loot_time % BOSS_LOOT_BLINK < BOSS_LOOT_BLINK / 2 && boss_loot_time > 0) {
+						queue.PushTextureRec(*loot_heart, { 2 * 16,8 * 16,16,16 }, { WINDOW_WIDTH / 2, bossSpawnY - 16 }, WHITE);
 					}
 				}
 			}
 
-			//enemy_killed = EnemyManager::Instance().GetKilled();
+			//enemy_killed = world->enemies.GetKilled();
 
 			//if (player->weapon->GetFrame() == 2 && enemy_killed) {
 			//	if (!got_enemy_pos) {
-			//		enemy_killed_pos = EnemyManager::Instance().GetKilledPos();
+			//		enemy_killed_pos = world->enemies.GetKilledPos();
 			//		got_enemy_pos = true;
 			//	}
 			//}
@@ -1462,88 +1598,51 @@ void Scene::Render()
 			//	}
 			//}
 
-			if (EnemyManager::Instance().DeleteTraderPopUp()) {
-				DeletePopUp();
-			}
-
-			if (EnemyManager::Instance().GetTraderPopUp() && popUpDisplayed == false)
+			if (world->enemies.GetTraderPopUp() && popUpDisplayed == false)
 			{
-				DrawTextureRec(*popup_trader, { 0,0,128,32 }, { 176,120 }, WHITE);
+				queue.PushTextureRec(*popup_trader, { 0,0,128,32 }, { 176,120 }, WHITE);
 			}
 			
 
+			queue.SetLayer(RenderLayer::PLAYER);
 			if(player->GetDamagedDelay() > 0){
-				if (player->GetDamagedDelay() % 12 == 0 || player->GetDamagedDelay() % 12 == 1 || player->GetDamagedDelay() % 12 == 2 ||
-					player->GetDamagedDelay() % 12 == 3 || player->GetDamagedDelay() % 12 == 4 || player->GetDamagedDelay() % 12 == 5) {
+				if (player->GetDamagedDelay() % DAMAGED_BLINK < DAMAGED_BLINK / 2) {
 					player->Draw();
 				}
 			}
 			else {
 				player->Draw();
 			}
+			queue.SetLayer(RenderLayer::WEAPON);
 			if (player->GetState() != State::DAMAGED) {
 				player->weapon->Draw();
 			}
 		}
+		//Hitboxes are drawn directly on top of the sprites
+		queue.Flush();
 		if (debug == DebugMode::SPRITES_AND_HITBOXES || debug == DebugMode::ONLY_HITBOXES)
 		{
 			if (currentLevel == 7 && currentFloor == 1) {
 				bossDoor->DrawDebug(PURPLE);
 			}
 			RenderObjectsDebug(YELLOW);
-			EnemyManager::Instance().RenderDebug();
+			world->enemies.RenderDebug();
 			player->DrawDebug(GREEN);
 			if (player->GetState() != State::DAMAGED) {
 				player->weapon->DrawDebug(RED);
 			}
 
 		}
+		queue.SetLayer(RenderLayer::FOREGROUND);
 		level->RenderLate();
-
-
-		deathExecuted = false;
-	}
-	else if(player->IsDead() && deathExecuted == false){
-		if (player->GetLives() <= 0) {
-			AudioPlayer::Instance().StopMusicByName("VampireKiller");
-			AudioPlayer::Instance().StopMusicByName("BossMusic");
-			renderingGameOver = true;
-			deathExecuted = true;
-		}
-		else {
-			player->DecrLives(1);
-			deathExecuted = true;
-			AudioPlayer::Instance().StopMusicByName("VampireKiller");
-			AudioPlayer::Instance().StopMusicByName("BossMusic");
-			
-			player->SetPos({ 20,140 });
-			player->SetState(State::IDLE);
-			player->weapon->SetWeapon(WeaponType::WHIP);
-			player->SetLook(Look::RIGHT);
-			player->InitLife();
-			player->InitHearts();
-			if (player->HasShield()) {
-				player->SwitchShield();
-			}
-			if (player->HasChestKey()) {
-				player->SwitchChestKey();
-			}
-			boss_spawned = false;
-
-			if (currentLevel > 3) {
-				LoadLevel(4, 0);
-			}
-			else {
-				LoadLevel(1, 0);
-			}
-		}
 	}
 
 	if (renderingGameOver) {
+		queue.SetLayer(RenderLayer::GAME_OVER);
 		RenderGameOver();
 	}
 
-	EndMode2D();
+	queue.EndCamera();
 
 	if (debug == DebugMode::SPRITES_AND_HITBOXES || debug == DebugMode::ONLY_HITBOXES) {
 		if (player->IsGodMode()) {
@@ -1552,15 +1651,312 @@ void Scene::Render()
 		else {
 			DrawText("GOD MODE : OFF", 10, 50, 8, LIGHTGRAY);
 		}
+		//Batching of the last complete frame
+		const RenderStats& stats = queue.GetLastStats();
+		DrawText(TextFormat("DRAW CALLS : %d FOR %d SPRITES", stats.draw_calls, stats.commands), 10, 60, 8, LIGHTGRAY);
+		DrawText(TextFormat("TEXTURE SWITCHES : %d (UNSORTED %d)", stats.texture_switches, stats.unsorted_switches), 10, 70, 8, LIGHTGRAY);
+		float minutes = (float)playTicks / TIME_TO_TICKS(60.0);
+		DrawText(TextFormat("HUD REBUILDS : %d (%.1f PER MINUTE)", hudRebuilds, minutes > 0.0f ? hudRebuilds / minutes : 0.0f), 10, 80, 8, LIGHTGRAY);
+		MemTagStats heap = MemTracker::GetTotal();
+		DrawText(TextFormat("HEAP : %d KB (PEAK %d KB)", (int)(heap.live_bytes / 1024), (int)(heap.peak_bytes / 1024)), 10, 90, 8, LIGHTGRAY);
+		DrawText(TextFormat("ALLOCATIONS : %d LAST FRAME", FrameArena::Instance().GetLastFrameAllocations()), 10, 100, 8, LIGHTGRAY);
+		DrawText(TextFormat("MAP %dK ENT %dK SPR %dK AUD %dK RES %dK",
+			(int)(MemTracker::GetStats(MemTag::TILEMAP).live_bytes / 1024), (int)(MemTracker::GetStats(MemTag::ENTITIES).live_bytes / 1024),
+			(int)(MemTracker::GetStats(MemTag::SPRITES).live_bytes / 1024), (int)(MemTracker::GetStats(MemTag::AUDIO).live_bytes / 1024),
+			(int)(MemTracker::GetStats(MemTag::RESOURCES).live_bytes / 1024)), 10, 110, 8, LIGHTGRAY);
+		//Textures and audio loaded by owner, red past their budget
+		ResourceBudget& budget = ResourceBudget::Instance();
+		DrawText(TextFormat("VRAM %dK (GAME %dK SCENE %dK ENEMIES %dK)", (int)(budget.GetTotal(ResourceKind::TEXTURE) / 1024),
+			(int)(budget.GetTotal(ResourceKind::TEXTURE, ResourceOwner::GAME) / 1024), (int)(budget.GetTotal(ResourceKind::TEXTURE, ResourceOwner::SCENE) / 1024),
+			(int)(budget.GetTotal(ResourceKind::TEXTURE, ResourceOwner::ENEMIES) / 1024)), 10, 120, 8,
+			budget.IsOverBudget(ResourceKind::TEXTURE) ? RED : LIGHTGRAY);
+		DrawText(TextFormat("AUDIO %dK (SOUNDS %dK MUSIC %dK)",
+			(int)((budget.GetTotal(ResourceKind::SOUND) + budget.GetTotal(ResourceKind::MUSIC)) / 1024),
+			(int)(budget.GetTotal(ResourceKind::SOUND) / 1024), (int)(budget.GetTotal(ResourceKind::MUSIC) / 1024)), 10, 130, 8,
+			budget.IsOverBudget(ResourceKind::SOUND) || budget.IsOverBudget(ResourceKind::MUSIC) ? RED : LIGHTGRAY);
+	}
+
+	if (hudTarget.id != 0)
+	{
+		//Render textures are stored upside down
+		Rectangle src = { 0, 0, (float)hudTarget.texture.width, -(float)hudTarget.texture.height };
+		queue.SetLayer(RenderLayer::HUD);
+		queue.PushTextureRec(hudTarget.texture, src, { 0, 0 }, WHITE);
+	}
+	else
+	{
+		RenderGUI(GetHudValues());
 	}
+	queue.Flush();
 
-	RenderGUI();
+}
+void Scene::HandleDeath()
+{
+	if (!player->IsDead())
+	{
+		deathExecuted = false;
+		return;
+	}
+	if (deathExecuted) return;
+
+	if (player->GetLives() <= 0) {
+		world->audio.StopMusicByName("VampireKiller");
+		world->audio.StopMusicByName("BossMusic");
+		renderingGameOver = true;
+		deathExecuted = true;
+	}
+	else {
+		player->DecrLives(1);
+		deathExecuted = true;
+		world->audio.StopMusicByName("VampireKiller");
+		world->audio.StopMusicByName("BossMusic");
+		
+		player->SetPos({ 20,140 });
+		player->SetState(State::IDLE);
+		player->weapon->SetWeapon(WeaponType::WHIP);
+		player->SetLook(Look::RIGHT);
+		player->InitLife();
+		player->InitHearts();
+		if (player->HasShield()) {
+			player->SwitchShield();
+		}
+		if (player->HasChestKey()) {
+			player->SwitchChestKey();
+		}
+		boss_spawned = false;
+
+		if (currentLevel > 3) {
+			LoadLevel(4, 0);
+		}
+		else {
+			LoadLevel(1, 0);
+		}
+	}
+}
+void Scene::SaveState(std::vector<unsigned char>& buffer) const
+{
+	buffer.clear();
+	BinaryWriter out(buffer);
+	out.Write(SNAPSHOT_MAGIC);
+	out.Write(SNAPSHOT_VERSION);
+
+	out.Write(currentLevel);
+	out.Write(currentFloor);
+	SaveFlags(out);
+	level->SaveState(out);
+	player->SaveState(out);
+	bossDoor->SaveState(out);
+
+	//Objects of every room, picked objects must stay removed after restoring
+	for (int stage = 0; stage < ROOM_STAGES; ++stage)
+	{
+		for (int floor = 0; floor < ROOM_FLOORS; ++floor)
+		{
+			const std::vector<Object*>& objects = roomObjects[stage][floor];
+			out.Write((int)objects.size());
+			for (const Object* obj : objects)
+			{
+				Point pos = obj->GetPos();
+				Vector2 room = obj->GetObjectLevel();
+				out.WriteEnum(obj->GetType());
+				out.WriteEnum(obj->GetLoot());
+				out.Write(obj->GetDistanceToFloor());
+				out.Write(pos.x);
+				out.Write(pos.y);
+				out.Write(room);
+				obj->SaveState(out);
+			}
+		}
+	}
+	world->enemies.SaveEnemies(out);
+	SealSnapshot(buffer);
+}
+AppStatus Scene::LoadState(const std::vector<unsigned char>& buffer)
+{
+	//The whole snapshot is checked before the scene is touched, a rejected one leaves the game as it was
+	if (!IsSnapshotSealed(buffer))
+	{
+		LOG("Snapshot is truncated or corrupted");
+		return AppStatus::ERROR;
+	}
+	BinaryReader in(buffer.data(), buffer.size() - SNAPSHOT_SEAL_SIZE);
+	unsigned int magic = 0;
+	int version = 0;
+	in.Read(magic);
+	in.Read(version);
+	if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+	{
+		LOG("Invalid snapshot (version %d, expected %d)", version, SNAPSHOT_VERSION);
+		return AppStatus::ERROR;
+	}
 
-	DrawTexture(*hud, 0, 0, WHITE);
+	//Loading the room sets the tile map size and the active objects, its tiles are overwritten next.
+	//A snapshot of the current room, as every rewind step but the ones crossing a door, keeps it loaded
+	int stage = 0, floor = 0;
+	in.Read(stage);
+	in.Read(floor);
+	bool same_room = stage == currentLevel && floor == currentFloor;
+	if (!in.IsOk() || (!same_room && LoadLevel(stage, floor) != AppStatus::OK))
+	{
+		LOG("Failed to restore the snapshot room");
+		return AppStatus::ERROR;
+	}
+	LoadFlags(in);
+	if (level->LoadState(in) != AppStatus::OK)
+	{
+		return AppStatus::ERROR;
+	}
+	player->LoadState(in);
+	bossDoor->LoadState(in);
 
+	//Objects matching the snapshot keep living and only get their animation back, the ones after
+	//the first difference (an object picked or dropped since then) are created again
+	for (int s = 0; s < ROOM_STAGES; ++s)
+	{
+		for (int f = 0; f < ROOM_FLOORS; ++f)
+		{
+			std::vector<Object*>& objects = roomObjects[s][f];
+			int count = 0;
+			in.Read(count);
+			for (int i = 0; i < count && in.IsOk(); ++i)
+			{
+				ObjectType type = ObjectType::CHAIN, loot = ObjectType::CHAIN;
+				int distance = 0;
+				Point pos;
+				Vector2 room = { 0,0 };
+				in.ReadEnum(type);
+				in.ReadEnum(loot);
+				in.Read(distance);
+				in.Read(pos.x);
+				in.Read(pos.y);
+				in.Read(room);
+
+				Object* obj = i < (int)objects.size() ? objects[i] : nullptr;
+				if (obj == nullptr || obj->GetType() != type || obj->GetLoot() != loot || obj->GetDistanceToFloor() != distance)
+				{
+					while ((int)objects.size() > i)
+					{
+						delete objects.back();
+						objects.pop_back();
+					}
+					obj = new Object(pos, type, room, loot, distance);
+					objects.push_back(obj);
+				}
+				obj->LoadState(in);
+			}
+			while ((int)objects.size() > count)
+			{
+				delete objects.back();
+				objects.pop_back();
+			}
+		}
+	}
+	if (world->enemies.LoadEnemies(in) != AppStatus::OK || !in.IsOk())
+	{
+		LOG("Snapshot is truncated or corrupted");
+		return AppStatus::ERROR;
+	}
+	world->enemies.SetTilemap(level);
+	return AppStatus::OK;
+}
+void Scene::SaveFlags(BinaryWriter& out) const
+{
+	out.Write(zombie_delay_time);
+	out.Write(bat_delay_time);
+	out.WriteBool(boss_spawned);
+	out.Write(hit_effect_time);
+	out.WriteBool(enemy_killed);
+	out.WriteBool(got_enemy_pos);
+	out.Write(enemy_killed_pos);
+	out.WriteBool(gotBoots);
+	out.Write(boot_time);
+	out.WriteBool(gotWings);
+	out.Write(wings_time);
+	out.WriteBool(gotShield);
+	out.Write(shield_time);
+	out.WriteBool(gotHeart);
+	out.Write(heart_time);
+	out.WriteBool(deathExecuted);
+	out.WriteBool(renderingGameOver);
+	out.WriteBool(level6WallBroken);
+	out.WriteBool(level7_1WallBroken);
+	out.Write(chest_time);
+	out.WriteBool(chestOpening);
+	out.Write(currentChestX);
+	out.Write(currentChestY);
+	out.WriteEnum(currentChestType);
+	out.Write(loot_time);
+	out.WriteBool(lootOpening);
+	out.Write(currentLootX);
+	out.Write(currentLootY);
+	out.WriteEnum(currentLootType);
+	out.Write(spawnY);
+	out.Write(loot_carry);
+	out.Write(bossSpawnY);
+	out.Write(boss_loot_time);
+	out.Write(boss_loot_carry);
+	out.WriteBool(boss_loot_spawned);
+	out.WriteBool(traderSpawned);
+	out.WriteBool(popUpDisplayed);
+	out.Write(world->random.GetState());
+}
+void Scene::LoadFlags(BinaryReader& in)
+{
+	in.Read(zombie_delay_time);
+	in.Read(bat_delay_time);
+	in.ReadBool(boss_spawned);
+	in.Read(hit_effect_time);
+	in.ReadBool(enemy_killed);
+	in.ReadBool(got_enemy_pos);
+	in.Read(enemy_killed_pos);
+	in.ReadBool(gotBoots);
+	in.Read(boot_time);
+	in.ReadBool(gotWings);
+	in.Read(wings_time);
+	in.ReadBool(gotShield);
+	in.Read(shield_time);
+	in.ReadBool(gotHeart);
+	in.Read(heart_time);
+	in.ReadBool(deathExecuted);
+	in.ReadBool(renderingGameOver);
+	in.ReadBool(level6WallBroken);
+	in.ReadBool(level7_1WallBroken);
+	in.Read(chest_time);
+	in.ReadBool(chestOpening);
+	in.Read(currentChestX);
+	in.Read(currentChestY);
+	in.ReadEnum(currentChestType);
+	in.Read(loot_time);
+	in.ReadBool(lootOpening);
+	in.Read(currentLootX);
+	in.Read(currentLootY);
+	in.ReadEnum(currentLootType);
+	in.Read(spawnY);
+	in.Read(loot_carry);
+	in.Read(bossSpawnY);
+	in.Read(boss_loot_time);
+	in.Read(boss_loot_carry);
+	in.ReadBool(boss_loot_spawned);
+	in.ReadBool(traderSpawned);
+	in.ReadBool(popUpDisplayed);
+
+	unsigned long long random = world->random.GetState();
+	in.Read(random);
+	world->random.SetState(random);
 }
 void Scene::Release()
 {
+	if (hudTarget.id != 0)
+	{
+		if (playTicks > 0)
+		{
+			float minutes = (float)playTicks / TIME_TO_TICKS(60.0);
+			LOG("HUD drawn %d times in %.1f minutes of play (%.1f per minute)", hudRebuilds, minutes, hudRebuilds / minutes);
+		}
+		UnloadRenderTexture(hudTarget);
+		hudTarget = {};
+	}
+
 	ResourceManager& data = ResourceManager::Instance();
 	data.ReleaseTexture(Resource::IMG_GAME_OVER);
 	data.ReleaseTexture(Resource::IMG_HUD);
@@ -1571,6 +1967,8 @@ void Scene::Release()
     level->Release();
 	player->Release();
 	ClearLevel();
+	//Enemies hold a pointer to the player
+	world->enemies.DestroyEnemies();
 }
 bool Scene::PlayerIsDead() const {
 	if (player->GetLives() <= 0) {
@@ -1583,239 +1981,249 @@ bool Scene::PlayerIsDead() const {
 bool Scene::PlayerHasWon() const {
 	return player->HasWon();
 }
+const Player* Scene::GetPlayer() const
+{
+	return player;
+}
+int Scene::GetCurrentLevel() const
+{
+	return currentLevel;
+}
+int Scene::GetCurrentFloor() const
+{
+	return currentFloor;
+}
 void Scene::DeletePopUp()
 {
 	popUpDisplayed = true;
 }
+void Scene::BuildBroadphase()
+{
+	broadphase.Clear();
+
+	world->enemies.RegisterColliders(broadphase);
+	std::vector<Object*>& objects = *activeObjects;
+	for (int i = 0; i < objects.size(); ++i)
+	{
+		broadphase.Insert(i, objects[i]->GetHitbox(), ColliderLayer::OBJECT);
+	}
+	broadphase.Insert(0, player->GetHitbox(), ColliderLayer::PLAYER);
+	if (player->weapon->GetFrame() == 2) {
+		broadphase.Insert(0, player->weapon->HitboxOnAttack(), ColliderLayer::WEAPON);
+	}
+	broadphase.Build();
+
+	//Enemies far from the player and the weapon skip their hit tests on the next update
+	world->enemies.UpdateProximity(broadphase);
+}
 void Scene::CheckCollisions()
 {
 	AABB player_box, obj_box;
+	std::vector<Object*>& objects = *activeObjects;
+	EventBus& events = world->events;
 	
 	player_box = player->GetHitbox();
-	auto it = objects.begin();
-	while (it != objects.end())
+
+	//Only the objects of the current room overlapping the player or the weapon are tested
+	candidates.clear();
+	broadphase.Query(player_box, ColliderLayer::OBJECT, candidates);
+	if (player->weapon->GetFrame() == 2) {
+		broadphase.Query(player->weapon->HitboxOnAttack(), ColliderLayer::OBJECT, candidates);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	//Effects of the collisions are applied later by ProcessEvents(), so the keys picked or spent
+	//this tick are tracked here to never open two chests with one key or pick two keys of a kind
+	bool chestKey = player->HasChestKey();
+	bool doorKey = player->HasDoorKey();
+	for (int id : candidates)
 	{
-		Vector2 currentObjLevel = (*it)->GetObjectLevel();
-		if (currentObjLevel.x != currentLevel || currentObjLevel.y != currentFloor)
-		{
-			++it;
-			continue;
-		}
-		obj_box = (*it)->GetHitbox();
-		if ((*it)->GetType() == ObjectType::FIRE || (*it)->GetType() == ObjectType::CANDLE) {
+		Object* obj = objects[id];
+		ObjectType type = obj->GetType();
+		bool picked = false;
+
+		obj_box = obj->GetHitbox();
+		if (type == ObjectType::FIRE || type == ObjectType::CANDLE) {
 			if (player->weapon->GetFrame() == 2) {
 				if (player->weapon->HitboxOnAttack().TestAABB(obj_box)) {
-					AudioPlayer::Instance().PlaySoundByName("Attack");
-					lootOpening = true;
-					currentLootType = (*it)->GetLoot();
-					currentLootX = (*it)->GetPos().x;
-					currentLootY = (*it)->GetPos().y;
-					spawnY = currentLootY;
-					loot_time = (*it)->GetDistanceToFloor();
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
+					events.PushItem(EventType::LOOT_RELEASED, obj->GetPos(), obj->GetLoot(), obj->GetDistanceToFloor());
+					picked = true;
 				}
 			}
-			else {
-				++it;
-			}
 		}
 		else if(player_box.TestAABB(obj_box))
 		{
+			bool chest = type == ObjectType::CHEST_CHAIN || type == ObjectType::CHEST_SHIELD || type == ObjectType::CHEST_BOOTS ||
+				type == ObjectType::CHEST_WINGS || type == ObjectType::CHEST_HEART;
 
-			if ((*it)->GetType() == ObjectType::CHAIN) {
-				AudioPlayer::Instance().PlaySoundByName("Collect");
-				player->weapon->SetWeapon(WeaponType::CHAIN);
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::BOSS_BALL) {
-				AudioPlayer::Instance().PlaySoundByName("Collect");
-				AudioPlayer::Instance().StopMusicByName("VampireKiller");
-				AudioPlayer::Instance().StopMusicByName("BossMusic");
-				player->Win();
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::HEART_BIG) {
-				AudioPlayer::Instance().PlaySoundByName("GetHeart");
-				player->IncrHearts(5);
-				gotHeart = true;
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::HEART_SMALL) {
-				AudioPlayer::Instance().PlaySoundByName("GetHeart");
-				player->IncrHearts(1);
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::BOOTS) {
-				AudioPlayer::Instance().PlaySoundByName("Collect");
-				gotBoots = true;
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::WINGS) {
-				AudioPlayer::Instance().PlaySoundByName("Collect");
-				gotWings = true;
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::SHIELD) {
-				AudioPlayer::Instance().PlaySoundByName("Collect");
-				if (!player->HasShield()) {
-					player->SwitchShield();
-				}
-				gotShield = true;
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
-			}
-			else if ((*it)->GetType() == ObjectType::KEY_CHEST) {
-				if (!player->HasChestKey()) {
-					AudioPlayer::Instance().PlaySoundByName("Collect");
-					player->SwitchChestKey();
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else if ((*it)->GetType() == ObjectType::KEY_DOOR) {
-				if (!player->HasDoorKey()) {
-					AudioPlayer::Instance().PlaySoundByName("GetDoorKey");
-					player->SwitchDoorKey();
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else if ((*it)->GetType() == ObjectType::CHEST_CHAIN) {
-				if (player->HasChestKey()) {
-					chestOpening = true;
-					currentChestType = ObjectType::CHEST_CHAIN;
-					currentChestX = (float)(*it)->GetPos().x;
-					currentChestY = (*it)->GetPos().y;
-					player->SwitchChestKey();
-					AudioPlayer::Instance().PlaySoundByName("OpenChest");
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else if ((*it)->GetType() == ObjectType::CHEST_SHIELD) {
-				if (player->HasChestKey()) {
-					chestOpening = true;
-					currentChestType = ObjectType::CHEST_SHIELD;
-					currentChestX = (float)(*it)->GetPos().x;
-					currentChestY = (*it)->GetPos().y;
-					player->SwitchChestKey();
-					AudioPlayer::Instance().PlaySoundByName("OpenChest");
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else if ((*it)->GetType() == ObjectType::CHEST_BOOTS) {
-				if (player->HasChestKey()) {
-					chestOpening = true;
-					currentChestType = ObjectType::CHEST_BOOTS;
-					currentChestX = (float)(*it)->GetPos().x;
-					currentChestY = (*it)->GetPos().y;
-					player->SwitchChestKey();
-					AudioPlayer::Instance().PlaySoundByName("OpenChest");
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else if ((*it)->GetType() == ObjectType::CHEST_WINGS) {
-				if (player->HasChestKey()) {
-					chestOpening = true;
-					currentChestType = ObjectType::CHEST_WINGS;
-					currentChestX = (float)(*it)->GetPos().x;
-					currentChestY = (*it)->GetPos().y;
-					player->SwitchChestKey();
-					AudioPlayer::Instance().PlaySoundByName("OpenChest");
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else if ((*it)->GetType() == ObjectType::CHEST_HEART) {
-				if (player->HasChestKey()) {
-					chestOpening = true;
-					currentChestType = ObjectType::CHEST_HEART;
-					currentChestX = (float)(*it)->GetPos().x;
-					currentChestY = (*it)->GetPos().y;
-					player->SwitchChestKey();
-					AudioPlayer::Instance().PlaySoundByName("OpenChest");
-					//Delete the object
-					delete* it;
-					//Erase the object from the vector and get the iterator to the next valid element
-					it = objects.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
-			else {
-				//Delete the object
-				delete* it;
-				//Erase the object from the vector and get the iterator to the next valid element
-				it = objects.erase(it);
+			if (chest)								picked = chestKey;
+			else if (type == ObjectType::KEY_CHEST)	picked = !chestKey;
+			else if (type == ObjectType::KEY_DOOR)	picked = !doorKey;
+			else									picked = true;
+
+			if (picked && (chest || type == ObjectType::KEY_CHEST))	chestKey = !chestKey;
+			if (picked && type == ObjectType::KEY_DOOR)				doorKey = true;
+
+			if (picked) {
+				events.PushItem(chest ? EventType::CHEST_OPENED : EventType::ITEM_COLLECTED, obj->GetPos(), type, 0);
 			}
 		}
-		else
-		{
-			//Move to the next object
-			++it; 
+		if (picked) {
+			//Delete the object, the slot is removed after the loop
+			delete obj;
+			objects[id] = nullptr;
 		}
 	}
+	//Remove the picked objects, from the last one so the moved objects are never pending removal
+	for (int i = (int)candidates.size() - 1; i >= 0; --i)
+	{
+		if (objects[candidates[i]] == nullptr) RemoveObject(candidates[i]);
+	}
 	//CheckCollisionsStairs();
 }
+void Scene::ProcessEvents()
+{
+	EventBus& events = world->events;
+	Object* obj;
+
+	for (const GameEvent& ev : events.GetEvents())
+	{
+		switch (ev.type)
+		{
+			case EventType::ENEMY_KILLED:
+				player->IncrScore(ev.value);
+				break;
+
+			case EventType::ENEMY_HIT:
+				QueueSound("Attack");
+				break;
+
+			case EventType::PLAYER_DAMAGED:
+				player->DecrLife(ev.value);
+				break;
+
+			case EventType::ITEM_PURCHASED:
+				player->DecrHearts(ev.value);
+				if (ev.item == ObjectType::CHAIN) player->weapon->SetWeapon(WeaponType::CHAIN);
+				break;
+
+			case EventType::LOOT_RELEASED:
+				QueueSound("Attack");
+				lootOpening = true;
+				currentLootType = ev.item;
+				currentLootX = ev.pos.x;
+				currentLootY = ev.pos.y;
+				spawnY = currentLootY;
+				//Ticks to fall the distance to the floor
+				loot_time = ev.value * SIM_TICKS_PER_SECOND / LOOT_FALL_SPEED;
+				loot_carry = 0;
+				break;
+
+			case EventType::CHEST_OPENED:
+				QueueSound("OpenChest");
+				chestOpening = true;
+				currentChestType = ev.item;
+				currentChestX = (float)ev.pos.x;
+				currentChestY = ev.pos.y;
+				player->SetChestKey(false);
+				break;
+
+			case EventType::ITEM_COLLECTED:
+				CollectItem(ev.item);
+				break;
+
+			case EventType::WALL_BROKEN:
+				QueueSound("BreakWalls");
+				level->TurnIntoAir();
+				if (currentLevel == 6 && currentFloor == 0) {
+					obj = new Object({ 144,160 }, ObjectType::KEY_DOOR, { 6, 0 });
+					AddObject(obj);
+					level6WallBroken = true;
+				}
+				else if (currentLevel == 7 && currentFloor == 1) {
+					level7_1WallBroken = true;
+					if (!traderSpawned) {
+						world->enemies.SpawnTrader({ 205,175 });
+						traderSpawned = true;
+					}
+				}
+				break;
+		}
+	}
+
+	//A sound triggered by several events of the same frame is played once
+	for (const char* sound : frameSounds)
+	{
+		world->audio.PlaySoundByName(sound);
+	}
+	frameSounds = FrameVector<const char*>();
+	events.EndFrame();
+}
+void Scene::CollectItem(ObjectType type)
+{
+	switch (type)
+	{
+		case ObjectType::CHAIN:
+			QueueSound("Collect");
+			player->weapon->SetWeapon(WeaponType::CHAIN);
+			break;
+
+		case ObjectType::BOSS_BALL:
+			QueueSound("Collect");
+			world->audio.StopMusicByName("VampireKiller");
+			world->audio.StopMusicByName("BossMusic");
+			player->Win();
+			break;
+
+		case ObjectType::HEART_BIG:
+			QueueSound("GetHeart");
+			player->IncrHearts(5);
+			gotHeart = true;
+			break;
+
+		case ObjectType::HEART_SMALL:
+			QueueSound("GetHeart");
+			player->IncrHearts(1);
+			break;
+
+		case ObjectType::BOOTS:
+			QueueSound("Collect");
+			gotBoots = true;
+			break;
+
+		case ObjectType::WINGS:
+			QueueSound("Collect");
+			gotWings = true;
+			break;
+
+		case ObjectType::SHIELD:
+			QueueSound("Collect");
+			if (!player->HasShield()) {
+				player->SwitchShield();
+			}
+			gotShield = true;
+			break;
+
+		case ObjectType::KEY_CHEST:
+			QueueSound("Collect");
+			player->SetChestKey(true);
+			break;
+
+		case ObjectType::KEY_DOOR:
+			QueueSound("GetDoorKey");
+			player->SetDoorKey(true);
+			break;
+	}
+}
+void Scene::QueueSound(const char* name)
+{
+	for (const char* sound : frameSounds)
+	{
+		if (strcmp(sound, name) == 0) return;
+	}
+	frameSounds.push_back(name);
+}
 void Scene::CheckCollisionsStairs()
 {
 	//bool hasOnStair = false;
@@ -1866,18 +2274,42 @@ void Scene::CheckCollisionsStairs()
 }
 void Scene::ClearLevel()
 {
-	for (Object* obj : objects)
+	for (int stage = 0; stage < ROOM_STAGES; ++stage)
 	{
+		for (int floor = 0; floor < ROOM_FLOORS; ++floor)
+		{
+			for (Object* obj : roomObjects[stage][floor])
+			{
+				delete obj;
+			}
+			roomObjects[stage][floor].clear();
+		}
+	}
+}
+void Scene::AddObject(Object* obj)
+{
+	Vector2 room = obj->GetObjectLevel();
+	int stage = (int)room.x;
+	int floor = (int)room.y;
+	if (stage < 0 || stage >= ROOM_STAGES || floor < 0 || floor >= ROOM_FLOORS)
+	{
+		LOG("Object placed in a room that doesn't exist: stage %d, floor %d", stage, floor);
 		delete obj;
+		return;
 	}
-	objects.clear();
+	roomObjects[stage][floor].push_back(obj);
+}
+void Scene::RemoveObject(int index)
+{
+	//Swap with the last object of the room and pop, the order of the objects doesn't matter
+	std::vector<Object*>& objects = *activeObjects;
+	objects[index] = objects.back();
+	objects.pop_back();
 }
 void Scene::RenderObjects() const
 {
-	for (Object* obj : objects)
+	for (Object* obj : *activeObjects)
 	{
-		Vector2 currentObjLevel = obj->GetObjectLevel();
-		if (currentObjLevel.x != currentLevel || currentObjLevel.y != currentFloor)	continue;
 		if (obj->GetType() == ObjectType::FIRE || obj->GetType() == ObjectType::CANDLE) {
 			obj->DrawAnimation();
 			continue;
@@ -1887,84 +2319,102 @@ void Scene::RenderObjects() const
 }
 void Scene::RenderObjectsDebug(const Color& col) const
 {
-	for (Object* obj : objects)
+	for (Object* obj : *activeObjects)
 	{
-		Vector2 currentObjLevel = obj->GetObjectLevel();
-		if (currentObjLevel.x != currentLevel || currentObjLevel.y != currentFloor)
-		{
-			continue;
-		}
 		obj->DrawDebug(col);
 	}
 }
-void Scene::RenderGUI() const
+bool HudValues::operator==(const HudValues& other) const
 {
-	DrawRectangle(0, 0, WINDOW_WIDTH, 46, { 6, 6, 6, 255 });
-
-	font->Draw(65, 14, TextFormat("%06d", player->GetScore()), WHITE);
-	
-	if (currentLevel <= 3) {
-		font->Draw(165, 14, "00", WHITE);
-	}
-	else if (currentLevel > 3) {
-		font->Draw(165, 14, "01", WHITE);
+	return score == other.score && lives == other.lives && hearts == other.hearts && life == other.life &&
+		boss_bar == other.boss_bar && stage == other.stage && chest_key == other.chest_key &&
+		door_key == other.door_key && chain == other.chain && item_frame == other.item_frame && item_x == other.item_x;
+}
+HudValues Scene::GetHudValues() const
+{
+	HudValues values;
+	values.score = player->GetScore();
+	values.lives = player->GetLives();
+	values.hearts = player->GetHearts();
+	values.life = player->GetLife();
+	values.boss_bar = currentLevel == 8 ? world->enemies.GetBossLife() * 4 : 64;
+	values.stage = currentLevel <= 3 ? 0 : 1;
+	values.chest_key = player->HasChestKey();
+	values.door_key = player->HasDoorKey();
+	values.chain = player->weapon->GetWeaponType() == WeaponType::CHAIN;
+
+	//The item just collected is shown while its message lasts, then the shield if the player has one
+	values.item_frame = -1;
+	values.item_x = 216;
+	if (gotBoots)					values.item_frame = 5;
+	else if (gotWings)				values.item_frame = 6;
+	else if (gotShield)				values.item_frame = 2;
+	else if (gotHeart)				values.item_frame = 7;
+	else if (player->HasShield())
+	{
+		values.item_frame = 2;
+		values.item_x = 208;
 	}
+	return values;
+}
+void Scene::PrepareHud()
+{
+	if (hudTarget.id == 0) return;
+
+	HudValues values = GetHudValues();
+	if (hudValid && values == hudValues) return;
+	hudValues = values;
+	hudValid = true;
+	hudRebuilds++;
+
+	BeginTextureMode(hudTarget);
+	ClearBackground(BLANK);
+	RenderGUI(values);
+	RenderQueue::Instance().Flush();
+	EndTextureMode();
+}
+void Scene::RenderGUI(const HudValues& values) const
+{
+	RenderQueue& queue = RenderQueue::Instance();
 
-	if (player->HasChestKey()) {
-		DrawTextureRec(*hud_items, { 3 * 16,0,16,16 }, { 156 ,26 }, WHITE);
-	}
-	if (player->HasDoorKey()) {
-		DrawTextureRec(*hud_items, { 4 * 16,0,16,16 }, { 172 ,26 }, WHITE);
-	}
+	queue.SetLayer(RenderLayer::HUD_BACKGROUND);
+	queue.PushRectangle(0, 0, WINDOW_WIDTH, 46, { 6, 6, 6, 255 });
 
-	if (player->weapon->GetWeaponType() == WeaponType::CHAIN) {
-		DrawTextureRec(*hud_items, { 0,0,16,16 }, { 136 ,26 }, WHITE);
-	}	
+	queue.SetLayer(RenderLayer::HUD);
 
-	if (player->GetLives() >= 0) {
-		font->Draw(237, 14, TextFormat("%02d", player->GetLives()), WHITE);
-	}
-	else {
-		font->Draw(237, 14, "00", WHITE);
-	}
+	//Numbers are written to a local buffer, TextFormat() shares static buffers and bots draw
+	//their HUD from several threads
+	char number[16];
 
-	if (player->GetHearts() >= 0) {
-		font->Draw(201, 14, TextFormat("%02d", player->GetHearts()), WHITE);
-	}
-	else {
-		font->Draw(201, 14, "00", WHITE);
-	}
+	font->Draw(65, 14, Text::FormatNumber(number, values.score, 6), WHITE);
+	font->Draw(165, 14, stageRuns[values.stage == 0 ? 0 : 1], WHITE);
 
-	if (player->GetLife() > 0) {
-		DrawRectangle(68, 28, player->GetLife() * 2, 4, { 247, 176, 144, 255 });
+	if (values.chest_key) {
+		queue.PushTextureRec(*hud_items, { 3 * 16,0,16,16 }, { 156 ,26 }, WHITE);
 	}
-
-	if (currentLevel == 8) {
-		DrawRectangle(68, 37, EnemyManager::Instance().GetBossLife()*4, 4, { 176, 6, 6, 255 });
+	if (values.door_key) {
+		queue.PushTextureRec(*hud_items, { 4 * 16,0,16,16 }, { 172 ,26 }, WHITE);
 	}
-	else {
-		DrawRectangle(68, 37, 64, 4, { 176, 6, 6, 255 });
+	if (values.chain) {
+		queue.PushTextureRec(*hud_items, { 0,0,16,16 }, { 136 ,26 }, WHITE);
 	}
 
-	if (gotBoots == true) {
-		DrawTextureRec(*hud_items, { 5 * 16,0,16,16 }, { 216 ,26 }, WHITE);
-	}
-	else if (gotWings == true) {
-		DrawTextureRec(*hud_items, { 6 * 16,0,16,16 }, { 216 ,26 }, WHITE);
-	}
-	else if (gotShield == true) {
-		DrawTextureRec(*hud_items, { 2 * 16,0,16,16 }, { 216 ,26 }, WHITE);
-	}
-	else if (gotHeart == true) {
-		DrawTextureRec(*hud_items, { 7 * 16,0,16,16 }, { 216 ,26 }, WHITE);
+	font->Draw(237, 14, Text::FormatNumber(number, values.lives >= 0 ? values.lives : 0, 2), WHITE);
+	font->Draw(201, 14, Text::FormatNumber(number, values.hearts >= 0 ? values.hearts : 0, 2), WHITE);
+
+	if (values.life > 0) {
+		queue.PushRectangle(68, 28, values.life * 2, 4, { 247, 176, 144, 255 });
 	}
-	else {
-		if (player->HasShield()) {
-			DrawTextureRec(*hud_items, { 2 * 16,0,16,16 }, { 208 ,26 }, WHITE);
-		}
+	queue.PushRectangle(68, 37, values.boss_bar, 4, { 176, 6, 6, 255 });
+
+	if (values.item_frame >= 0) {
+		queue.PushTextureRec(*hud_items, { (float)values.item_frame * 16,0,16,16 }, { (float)values.item_x ,26 }, WHITE);
 	}
+
+	queue.SetLayer(RenderLayer::HUD_FRAME);
+	queue.PushTexture(*hud, 0, 0, WHITE);
 }
 void Scene::RenderGameOver() const
 {
-	DrawTexture(*game_over, 16, 0, WHITE);
+	RenderQueue::Instance().PushTexture(*game_over, 16, 0, WHITE);
 }
\ No newline at end of file
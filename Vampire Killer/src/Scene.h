@@ -6,37 +6,125 @@
 #include "AudioPlayer.h"
 #include "Text.h"
 #include "Door.h"
+#include "SpatialHash.h"
+#include "EventBus.h"
+#include "World.h"
+#include "RewindBuffer.h"
+#include "FrameArena.h"
+
+//Rooms are indexed by stage (1 to 8) and floor (0 or 1)
+#define ROOM_STAGES		9
+#define ROOM_FLOORS		2
+
+//Objects animated by each job
+#define OBJECT_UPDATE_GRAIN	32
+
+//Durations of the scene timers
+#define CHEST_OPEN_TIME		TIME_TO_TICKS(1.0)
+#define LOOT_DROP_TIME		TIME_TO_TICKS(0.667)
+#define ZOMBIE_SPAWN_TIME	TIME_TO_TICKS(2.0)
+#define BAT_SPAWN_TIME		TIME_TO_TICKS(4.0)
+#define ITEM_MESSAGE_TIME	TIME_TO_TICKS(1.0)
+#define HIT_EFFECT_TIME		TIME_TO_TICKS(0.5)
+#define BOSS_LOOT_TIME		TIME_TO_TICKS(1.833)
+//Period of the four frame animation of the opening chests and the released loot
+#define LOOT_ANIM_PERIOD	TIME_TO_PERIOD(0.5)
+//Blinking period of the boss loot before it drops
+#define BOSS_LOOT_BLINK		TIME_TO_PERIOD(0.5)
+//Blinking period of the player while damaged, shown the first half
+#define DAMAGED_BLINK		TIME_TO_PERIOD(0.2)
+
+//Falling speed of the released loot, in pixels per second
+#define LOOT_FALL_SPEED		60
+
+//Quick save written by the debug keys, read back when there is none in memory
+#define QUICKSAVE_FILE	"quicksave.sav"
 
 enum class DebugMode { OFF, SPRITES_AND_HITBOXES, ONLY_HITBOXES, SIZE };
 
+//Everything the HUD shows, its cached texture is only drawn again when one of them changes
+struct HudValues
+{
+    int score;
+    int lives;
+    int hearts;
+    int life;
+    //Width of the boss health bar
+    int boss_bar;
+    int stage;
+    bool chest_key;
+    bool door_key;
+    bool chain;
+    //Frame and position of the item icon, -1 when there is none
+    int item_frame;
+    int item_x;
+
+    bool operator==(const HudValues& other) const;
+};
+
 class Scene
 {
 public:
-    Scene();
+    Scene(World* world);
     ~Scene();
 
+    //Start decoding the textures used while playing, so Init() finds them already loaded
+    static void PreloadTextures();
+
     AppStatus Init();
     void Update();
+    //Draw the HUD into its texture if a value changed, must be called outside any texture mode
+    void PrepareHud();
     void Render();
     void Release();
     bool PlayerIsDead() const;
     bool PlayerHasWon() const;
+    const Player* GetPlayer() const;
+    int GetCurrentLevel() const;
+    int GetCurrentFloor() const;
+
+    //Snapshot of the whole session (player, enemies, objects, room, tile edits, timers and flags)
+    //in a versioned binary buffer, the buffer is cleared first
+    void SaveState(std::vector<unsigned char>& buffer) const;
+    AppStatus LoadState(const std::vector<unsigned char>& buffer);
+
+    //Hash of the snapshot of the current state, see HashSnapshot()
+    unsigned long long GetStateHash();
+
+    //Record a snapshot per update so the rewind debug key can step back, on by default
+    void EnableRewind(bool enable);
     void DeletePopUp();
 private:
     AppStatus LoadLevel(int stage,int floor);
     
+    void BuildBroadphase();
     void CheckCollisions(); 
+    //Apply the gameplay events queued this frame
+    void ProcessEvents();
+    void CollectItem(ObjectType type);
+    void QueueSound(const char* name);
     void CheckCollisionsStairs();
+    void HandleDeath();
     void ClearLevel();
+    void AddObject(Object* obj);
+    void RemoveObject(int index);
     void RenderGameOver() const;
     void RenderObjects() const;
     void RenderObjectsDebug(const Color& col) const;
 
-    void RenderGUI() const;
+    HudValues GetHudValues() const;
+    void RenderGUI(const HudValues& values) const;
 
+    //Scene timers and flags of the snapshot
+    void SaveFlags(BinaryWriter& out) const;
+    void LoadFlags(BinaryReader& in);
+
+    World* world;
     Player *player;
     TileMap *level;
-    std::vector<Object*> objects;
+    //Objects bucketed by room, only the bucket of the current room is updated and tested
+    std::vector<Object*> roomObjects[ROOM_STAGES][ROOM_FLOORS];
+    std::vector<Object*>* activeObjects;
     int currentLevel;
     int currentFloor;
     const Texture2D* game_over;
@@ -51,19 +139,19 @@ private:
     
     bool boss_spawned = false;
 
-    int hit_effect_time = 30;
+    int hit_effect_time = HIT_EFFECT_TIME;
     bool enemy_killed = false;
     bool got_enemy_pos = false;
     Vector2 enemy_killed_pos;
 
     bool gotBoots = false;
-    int boot_time = 60;
+    int boot_time = ITEM_MESSAGE_TIME;
     bool gotWings = false;
-    int wings_time = 60;
+    int wings_time = ITEM_MESSAGE_TIME;
     bool gotShield = false;
-    int shield_time = 60;
+    int shield_time = ITEM_MESSAGE_TIME;
     bool gotHeart = false;
-    int heart_time = 60;
+    int heart_time = ITEM_MESSAGE_TIME;
 
     bool deathExecuted;
     bool renderingGameOver;
@@ -86,9 +174,11 @@ private:
     float currentLootY;
     ObjectType currentLootType;
     float spawnY;
+    int loot_carry;
 
     float bossSpawnY = 64;
-    int boss_loot_time = 110;
+    int boss_loot_time = BOSS_LOOT_TIME;
+    int boss_loot_carry = 0;
     bool boss_loot_spawned = false;
 
     Camera2D camera;
@@ -99,9 +189,35 @@ private:
     bool popUpDisplayed = false;
 
     Text* font;
+    //Stage numbers of the HUD, laid out once after loading the font
+    TextRun stageRuns[2];
 
     //Door
 
     Door* bossDoor;
+
+    //Broadphase rebuilt every frame before the collision checks
+    SpatialHash broadphase;
+    std::vector<int> candidates;
+
+    //Sounds requested by the events of the current frame, taken from the frame arena and
+    //released before ProcessEvents() returns
+    FrameVector<const char*> frameSounds;
+
+    //Last quick save, also written to QUICKSAVE_FILE
+    std::vector<unsigned char> quickSave;
+
+    //Last seconds of play, stepped back while the rewind key is held
+    RewindBuffer rewind;
+    std::vector<unsigned char> frameState;
+    bool recordRewind = true;
+
+    //HUD drawn by PrepareHud(), headless runs draw it every frame instead
+    RenderTexture2D hudTarget;
+    HudValues hudValues;
+    bool hudValid;
+    int hudRebuilds;
+    //Ticks played since Init(), the rebuilds are reported per minute of play
+    int playTicks;
 };
 
@@ -0,0 +1,118 @@
+#include "Snapshot.h"
+#include <stdio.h>
+
+BinaryWriter::BinaryWriter(std::vector<unsigned char>& buffer) : buffer(buffer)
+{
+}
+void BinaryWriter::WriteBool(bool value)
+{
+	Write((unsigned char)(value ? 1 : 0));
+}
+void BinaryWriter::WriteBytes(const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	buffer.insert(buffer.end(), bytes, bytes + size);
+}
+size_t BinaryWriter::GetSize() const
+{
+	return buffer.size();
+}
+
+BinaryReader::BinaryReader(const unsigned char* data, size_t size) : data(data), size(size)
+{
+	offset = 0;
+	ok = true;
+}
+void BinaryReader::ReadBool(bool& value)
+{
+	unsigned char v = value ? 1 : 0;
+	Read(v);
+	value = v != 0;
+}
+void BinaryReader::ReadBytes(void* dst, size_t count)
+{
+	if (!ok || count > size - offset)
+	{
+		ok = false;
+		return;
+	}
+	memcpy(dst, data + offset, count);
+	offset += count;
+}
+bool BinaryReader::IsOk() const
+{
+	return ok;
+}
+size_t BinaryReader::GetRemaining() const
+{
+	return size - offset;
+}
+
+static unsigned long long HashBytes(const unsigned char* data, size_t size)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+unsigned long long HashSnapshot(const std::vector<unsigned char>& buffer)
+{
+	return HashBytes(buffer.data(), buffer.size());
+}
+void SealSnapshot(std::vector<unsigned char>& buffer)
+{
+	unsigned long long hash = HashSnapshot(buffer);
+	BinaryWriter out(buffer);
+	out.Write(hash);
+}
+bool IsSnapshotSealed(const std::vector<unsigned char>& buffer)
+{
+	unsigned long long hash;
+	if (buffer.size() < SNAPSHOT_SEAL_SIZE) return false;
+
+	size_t size = buffer.size() - SNAPSHOT_SEAL_SIZE;
+	memcpy(&hash, buffer.data() + size, SNAPSHOT_SEAL_SIZE);
+	return HashBytes(buffer.data(), size) == hash;
+}
+AppStatus SaveSnapshotFile(const char* path, const std::vector<unsigned char>& buffer)
+{
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		LOG("Failed to open %s for writing", path);
+		return AppStatus::ERROR;
+	}
+	size_t written = fwrite(buffer.data(), 1, buffer.size(), file);
+	fclose(file);
+	if (written != buffer.size())
+	{
+		LOG("Failed to write snapshot %s", path);
+		return AppStatus::ERROR;
+	}
+	return AppStatus::OK;
+}
+AppStatus LoadSnapshotFile(const char* path, std::vector<unsigned char>& buffer)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+	{
+		LOG("Failed to open %s", path);
+		return AppStatus::ERROR;
+	}
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	buffer.resize(length > 0 ? (size_t)length : 0);
+	size_t read = fread(buffer.data(), 1, buffer.size(), file);
+	fclose(file);
+	if (read != buffer.size())
+	{
+		LOG("Failed to read snapshot %s", path);
+		return AppStatus::ERROR;
+	}
+	return AppStatus::OK;
+}
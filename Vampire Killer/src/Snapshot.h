@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <string.h>
+#include <type_traits>
+#include "Globals.h"
+
+//Header of every snapshot, the version must be increased whenever the saved fields change
+#define SNAPSHOT_MAGIC		0x53534B56u		//"VKSS"
+#define SNAPSHOT_VERSION	4
+//Hash of the snapshot appended after the saved fields
+#define SNAPSHOT_SEAL_SIZE	sizeof(unsigned long long)
+
+//Appends plain values to a byte buffer, values are stored with the size and byte order of the machine
+class BinaryWriter
+{
+public:
+    BinaryWriter(std::vector<unsigned char>& buffer);
+
+    template<typename T> void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        WriteBytes(&value, sizeof(T));
+    }
+    //Enums are stored in a single byte
+    template<typename E> void WriteEnum(E value)
+    {
+        Write((unsigned char)value);
+    }
+    void WriteBool(bool value);
+    void WriteBytes(const void* data, size_t size);
+
+    size_t GetSize() const;
+
+private:
+    std::vector<unsigned char>& buffer;
+};
+
+//Reads back the values of a BinaryWriter in the same order. Reading past the end leaves the
+//values untouched and marks the reader as failed, callers check IsOk() once at the end.
+class BinaryReader
+{
+public:
+    BinaryReader(const unsigned char* data, size_t size);
+
+    template<typename T> void Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        ReadBytes(&value, sizeof(T));
+    }
+    template<typename E> void ReadEnum(E& value)
+    {
+        unsigned char v = (unsigned char)value;
+        Read(v);
+        value = (E)v;
+    }
+    void ReadBool(bool& value);
+    void ReadBytes(void* data, size_t size);
+
+    bool IsOk() const;
+    size_t GetRemaining() const;
+
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+};
+
+//64-bit FNV-1a of a snapshot. Equal game states give equal hashes, so comparing the hash of
+//every tick between two builds finds the first frame where the simulations diverge.
+unsigned long long HashSnapshot(const std::vector<unsigned char>& buffer);
+
+//The last bytes of a snapshot are the hash of the ones before, a truncated or corrupted snapshot
+//doesn't match its seal and is rejected before restoring anything
+void SealSnapshot(std::vector<unsigned char>& buffer);
+bool IsSnapshotSealed(const std::vector<unsigned char>& buffer);
+
+//Write and read whole snapshots, used for quick saves
+AppStatus SaveSnapshotFile(const char* path, const std::vector<unsigned char>& buffer);
+AppStatus LoadSnapshotFile(const char* path, std::vector<unsigned char>& buffer);
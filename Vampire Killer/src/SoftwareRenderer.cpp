@@ -0,0 +1,236 @@
+#include "SoftwareRenderer.h"
+#include "ResourceManager.h"
+#include <math.h>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_SSE2
+#endif
+
+static unsigned int PackColor(const Color& col)
+{
+	return (unsigned int)col.r | ((unsigned int)col.g << 8) | ((unsigned int)col.b << 16) | ((unsigned int)col.a << 24);
+}
+//a * b / 255 rounded, exact for every pair of bytes
+static unsigned int MulByte(unsigned int a, unsigned int b)
+{
+	unsigned int x = a * b + 128;
+	return (x + (x >> 8)) >> 8;
+}
+static unsigned int Modulate(unsigned int s, const Color& tint)
+{
+	return MulByte(s & 0xFF, tint.r) | (MulByte((s >> 8) & 0xFF, tint.g) << 8) |
+		(MulByte((s >> 16) & 0xFF, tint.b) << 16) | (MulByte(s >> 24, tint.a) << 24);
+}
+//BLEND_ALPHA: src * alpha + dst * (1 - alpha) on the four channels
+static unsigned int Blend(unsigned int d, unsigned int s)
+{
+	unsigned int a = s >> 24;
+	if (a == 255) return s;
+	if (a == 0) return d;
+
+	unsigned int result = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		unsigned int c = MulByte((s >> shift) & 0xFF, a) + MulByte((d >> shift) & 0xFF, 255 - a);
+		result |= (c > 255 ? 255 : c) << shift;
+	}
+	return result;
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+{
+	this->width = width;
+	this->height = height;
+	pixels.assign(width * height, 0);
+	ResetCamera();
+}
+SoftwareRenderer::~SoftwareRenderer()
+{
+}
+void SoftwareRenderer::Clear(const Color& col)
+{
+	std::fill(pixels.begin(), pixels.end(), PackColor(col));
+}
+void SoftwareRenderer::SetCamera(const Camera2D& camera)
+{
+	zoom = camera.zoom;
+	offset_x = camera.offset.x - camera.target.x * camera.zoom;
+	offset_y = camera.offset.y - camera.target.y * camera.zoom;
+}
+void SoftwareRenderer::ResetCamera()
+{
+	zoom = 1.0f;
+	offset_x = 0.0f;
+	offset_y = 0.0f;
+}
+void SoftwareRenderer::Draw(const DrawCommand* commands, int count)
+{
+	//Commands come sorted by texture, the image is looked up once per run
+	ResourceManager& data = ResourceManager::Instance();
+	const Image* image = nullptr;
+	unsigned int current = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		const DrawCommand& command = commands[i];
+		if (!command.solid && command.texture != current)
+		{
+			image = data.GetImage(command.texture);
+			current = command.texture;
+		}
+		if (command.solid || image != nullptr) DrawQuad(command, image);
+	}
+}
+void SoftwareRenderer::DrawQuad(const DrawCommand& command, const Image* image)
+{
+	//A pixel is covered when its centre is inside the quad, same rule as the GPU
+	float x0 = command.dst.x * zoom + offset_x;
+	float y0 = command.dst.y * zoom + offset_y;
+	float x1 = x0 + command.dst.width * zoom;
+	float y1 = y0 + command.dst.height * zoom;
+	int px0 = (int)ceilf(x0 - 0.5f), px1 = (int)ceilf(x1 - 0.5f);
+	int py0 = (int)ceilf(y0 - 0.5f), py1 = (int)ceilf(y1 - 0.5f);
+	int cx0 = px0 < 0 ? 0 : px0, cx1 = px1 > width ? width : px1;
+	int cy0 = py0 < 0 ? 0 : py0, cy1 = py1 > height ? height : py1;
+	if (cx0 >= cx1 || cy0 >= cy1) return;
+
+	if (command.solid)
+	{
+		unsigned int s = PackColor(command.tint);
+		for (int y = cy0; y < cy1; ++y)
+		{
+			unsigned int* row = &pixels[y * width];
+			for (int x = cx0; x < cx1; ++x) row[x] = Blend(row[x], s);
+		}
+		return;
+	}
+
+	//Texel coordinates along the quad, flips as DrawTexturePro() does them
+	Rectangle src = command.src;
+	float u0 = src.x, du = src.width;
+	if (src.width < 0)
+	{
+		u0 = src.x - src.width;
+		du = src.width;
+	}
+	float v0 = src.y, dv = src.height;
+	if (src.height < 0) v0 = src.y - src.height;
+	du /= (x1 - x0);
+	dv /= (y1 - y0);
+
+	const unsigned int* texels = (const unsigned int*)image->data;
+	int tw = image->width, th = image->height;
+
+	//Unscaled quads step one texel per pixel and copy whole rows
+	int step = 0;
+	if (du == 1.0f || du == -1.0f)
+	{
+		float first = u0 + (cx0 + 0.5f - x0) * du;
+		int t0 = (int)floorf(first), t1 = t0 + (int)du * (cx1 - cx0 - 1);
+		if (first - t0 == 0.5f && t0 >= 0 && t0 < tw && t1 >= 0 && t1 < tw) step = (int)du;
+	}
+
+	for (int y = cy0; y < cy1; ++y)
+	{
+		int ty = (int)floorf(v0 + (y + 0.5f - y0) * dv);
+		if (ty < 0 || ty >= th) continue;
+		const unsigned int* texel_row = &texels[ty * tw];
+		unsigned int* row = &pixels[y * width];
+
+		if (step != 0)
+		{
+			int tx = (int)floorf(u0 + (cx0 + 0.5f - x0) * du);
+			BlendRow(row + cx0, texel_row + tx, cx1 - cx0, step, command.tint);
+			continue;
+		}
+		for (int x = cx0; x < cx1; ++x)
+		{
+			int tx = (int)floorf(u0 + (x + 0.5f - x0) * du);
+			if (tx < 0 || tx >= tw) continue;
+			row[x] = Blend(row[x], Modulate(texel_row[tx], command.tint));
+		}
+	}
+}
+void SoftwareRenderer::BlendRow(unsigned int* dst, const unsigned int* src, int count, int step, const Color& tint)
+{
+	int i = 0;
+	bool white = tint.r == 255 && tint.g == 255 && tint.b == 255 && tint.a == 255;
+#if defined(SOFTWARE_SSE2)
+	//Sprites are made of opaque and transparent texels, four of them are selected at once and
+	//only the groups with translucent texels are blended one by one
+	if (white)
+	{
+		const __m128i opaque_alpha = _mm_set1_epi32(255);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i s;
+			if (step > 0)
+			{
+				s = _mm_loadu_si128((const __m128i*)(src + i));
+			}
+			else
+			{
+				s = _mm_loadu_si128((const __m128i*)(src - i - 3));
+				s = _mm_shuffle_epi32(s, _MM_SHUFFLE(0, 1, 2, 3));
+			}
+			__m128i alpha = _mm_srli_epi32(s, 24);
+			__m128i opaque = _mm_cmpeq_epi32(alpha, opaque_alpha);
+			__m128i clear = _mm_cmpeq_epi32(alpha, _mm_setzero_si128());
+			if (_mm_movemask_epi8(_mm_or_si128(opaque, clear)) == 0xFFFF)
+			{
+				__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+				d = _mm_or_si128(_mm_and_si128(opaque, s), _mm_andnot_si128(opaque, d));
+				_mm_storeu_si128((__m128i*)(dst + i), d);
+			}
+			else
+			{
+				for (int k = i; k < i + 4; ++k) dst[k] = Blend(dst[k], src[k * step]);
+			}
+		}
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		unsigned int s = src[i * step];
+		dst[i] = Blend(dst[i], white ? s : Modulate(s, tint));
+	}
+}
+unsigned long long SoftwareRenderer::GetHash() const
+{
+	//FNV-1a over the 32-bit pixels
+	unsigned long long hash = 14695981039346656037ull;
+	for (unsigned int p : pixels)
+	{
+		hash ^= p;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+AppStatus SoftwareRenderer::Export(const char* path) const
+{
+	Image image = {};
+	image.data = (void*)pixels.data();
+	image.width = width;
+	image.height = height;
+	image.mipmaps = 1;
+	image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+	if (!ExportImage(image, path))
+	{
+		LOG("Failed to export frame %s", path);
+		return AppStatus::ERROR;
+	}
+	return AppStatus::OK;
+}
+int SoftwareRenderer::GetWidth() const
+{
+	return width;
+}
+int SoftwareRenderer::GetHeight() const
+{
+	return height;
+}
+unsigned int SoftwareRenderer::GetPixel(int x, int y) const
+{
+	return pixels[y * width + x];
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "raylib.h"
+#include "Globals.h"
+#include "RenderQueue.h"
+
+//Draws the commands of the render queue into an RGBA image in memory, so frames can be
+//rendered and compared on machines without a GPU. Textures are sampled like raylib's
+//point filter and blended like BLEND_ALPHA; the result is close to the GPU image but
+//only meant to be compared against other software frames.
+//Textures must be kept by the resource manager (ResourceManager::SetKeepImages).
+class SoftwareRenderer
+{
+public:
+    SoftwareRenderer(int width = WINDOW_WIDTH, int height = WINDOW_HEIGHT);
+    ~SoftwareRenderer();
+
+    void Clear(const Color& col);
+
+    //Transform of the commands drawn from now on, same as BeginMode2D() without rotation
+    void SetCamera(const Camera2D& camera);
+    void ResetCamera();
+
+    void Draw(const DrawCommand* commands, int count);
+
+    //Hash of the pixels, equal frames give equal hashes
+    unsigned long long GetHash() const;
+
+    //Write the frame to an image file, used to look at the frames that changed
+    AppStatus Export(const char* path) const;
+
+    int GetWidth() const;
+    int GetHeight() const;
+    //Pixel at (x, y) as 0xAABBGGRR
+    unsigned int GetPixel(int x, int y) const;
+
+private:
+    void DrawQuad(const DrawCommand& command, const Image* image);
+    void BlendRow(unsigned int* dst, const unsigned int* src, int count, int step, const Color& tint);
+
+    int width, height;
+    std::vector<unsigned int> pixels;
+
+    float offset_x, offset_y;
+    float zoom;
+};
@@ -0,0 +1,175 @@
+#include "SpatialHash.h"
+#include <algorithm>
+
+//Integer division rounding towards negative infinity, entities can be partially off the map
+static int FloorDiv(int a, int b)
+{
+	int q = a / b;
+	if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+	return q;
+}
+
+SpatialHash::SpatialHash()
+{
+	bucket_count = SPATIAL_BUCKETS;
+	bucket_start.resize(bucket_count + 1, 0);
+	stamp = 0;
+	candidates = 0;
+}
+SpatialHash::~SpatialHash()
+{
+}
+void SpatialHash::Clear()
+{
+	colliders.clear();
+	boxes.Clear();
+	cells.clear();
+	sorted.clear();
+	candidates = 0;
+}
+void SpatialHash::Insert(int id, const AABB& box, ColliderLayer layer)
+{
+	int index = (int)colliders.size();
+	colliders.push_back({ box, id, layer });
+	boxes.Add(box);
+
+	int x0, y0, x1, y1;
+	CellRange(box, x0, y0, x1, y1);
+	for (int cy = y0; cy <= y1; ++cy)
+	{
+		for (int cx = x0; cx <= x1; ++cx)
+		{
+			cells.push_back({ cx, cy, index });
+		}
+	}
+}
+void SpatialHash::Build()
+{
+	//Keep at least one bucket per occupied cell so crowded maps don't pile up in a few buckets
+	while (bucket_count < (int)cells.size()) bucket_count *= 2;
+	bucket_start.resize(bucket_count + 1);
+
+	//Counting sort of the registered cells by bucket
+	std::fill(bucket_start.begin(), bucket_start.end(), 0);
+	cell_bucket.resize(cells.size());
+	for (int i = 0; i < (int)cells.size(); ++i)
+	{
+		cell_bucket[i] = Bucket(cells[i].cx, cells[i].cy);
+		bucket_start[cell_bucket[i] + 1]++;
+	}
+	for (int b = 0; b < bucket_count; ++b)
+	{
+		bucket_start[b + 1] += bucket_start[b];
+	}
+
+	//bucket_start is used as the write cursor and then shifted back
+	sorted.resize(cells.size());
+	for (int i = 0; i < (int)cells.size(); ++i)
+	{
+		sorted[bucket_start[cell_bucket[i]]++] = cells[i].index;
+	}
+	for (int b = bucket_count; b > 0; --b)
+	{
+		bucket_start[b] = bucket_start[b - 1];
+	}
+	bucket_start[0] = 0;
+
+	if (stamps.size() < colliders.size()) stamps.resize(colliders.size(), 0);
+}
+void SpatialHash::Query(const AABB& box, ColliderLayer layer, std::vector<int>& result)
+{
+	scratch.clear();
+	QueryIndices(box, layer, scratch);
+	for (int index : scratch)
+	{
+		result.push_back(colliders[index].id);
+	}
+}
+void SpatialHash::QueryPairs(ColliderLayer a, ColliderLayer b, std::vector<std::pair<int, int>>& result)
+{
+	//scratch is reused by Query, keep a separate list
+	std::vector<int> found;
+	for (int i = 0; i < (int)colliders.size(); ++i)
+	{
+		if (colliders[i].layer != a) continue;
+
+		found.clear();
+		QueryIndices(colliders[i].box, b, found);
+		for (int j : found)
+		{
+			//Same layer: report (i, j) only once and never a collider against itself
+			if (a == b && j <= i) continue;
+			result.push_back({ colliders[i].id, colliders[j].id });
+		}
+	}
+}
+int SpatialHash::GetCount() const
+{
+	return (int)colliders.size();
+}
+int SpatialHash::GetCandidateCount() const
+{
+	return candidates;
+}
+void SpatialHash::CellRange(const AABB& box, int& x0, int& y0, int& x1, int& y1) const
+{
+	//TestAABB treats the right and bottom edges as inclusive
+	x0 = FloorDiv(box.pos.x, SPATIAL_CELL_SIZE);
+	y0 = FloorDiv(box.pos.y, SPATIAL_CELL_SIZE);
+	x1 = FloorDiv(box.pos.x + box.width, SPATIAL_CELL_SIZE);
+	y1 = FloorDiv(box.pos.y + box.height, SPATIAL_CELL_SIZE);
+}
+int SpatialHash::Bucket(int cx, int cy) const
+{
+	unsigned int h = ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+	return (int)(h & (unsigned int)(bucket_count - 1));
+}
+void SpatialHash::QueryIndices(const AABB& box, ColliderLayer layer, std::vector<int>& result)
+{
+	//A room holds a few dozen colliders, testing all of them at once is cheaper than walking cells
+	if ((int)colliders.size() <= SPATIAL_BATCH_MAX)
+	{
+		boxes.Test(box, hits);
+		candidates += (int)colliders.size();
+		for (int w = 0; w < (int)hits.size(); ++w)
+		{
+			for (unsigned int bits = hits[w]; bits != 0; bits &= bits - 1)
+			{
+				int bit = 0;
+				while (((bits >> bit) & 1u) == 0) bit++;
+
+				int index = w * 32 + bit;
+				if (colliders[index].layer == layer) result.push_back(index);
+			}
+		}
+		return;
+	}
+
+	stamp++;
+	if (stamp == 0)
+	{
+		//Stamp counter wrapped around, old marks could be mistaken for the current query
+		std::fill(stamps.begin(), stamps.end(), 0);
+		stamp = 1;
+	}
+
+	int x0, y0, x1, y1;
+	CellRange(box, x0, y0, x1, y1);
+	for (int cy = y0; cy <= y1; ++cy)
+	{
+		for (int cx = x0; cx <= x1; ++cx)
+		{
+			int b = Bucket(cx, cy);
+			for (int k = bucket_start[b]; k < bucket_start[b + 1]; ++k)
+			{
+				int index = sorted[k];
+				if (stamps[index] == stamp) continue;
+				stamps[index] = stamp;
+
+				if (colliders[index].layer != layer) continue;
+				candidates++;
+				if (colliders[index].box.TestAABB(box)) result.push_back(index);
+			}
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "AABB.h"
+
+//Side of a broadphase cell in pixels (two tiles)
+#define SPATIAL_CELL_SIZE	32
+
+//Minimum number of hash buckets, must be a power of two
+//Build() grows the table with the number of occupied cells
+#define SPATIAL_BUCKETS		1024
+
+//Up to this number of colliders the grid is skipped and queries test every box with the SIMD batch
+#define SPATIAL_BATCH_MAX	64
+
+//Collision groups registered in the broadphase
+enum class ColliderLayer { PLAYER, ENEMY, OBJECT, PROJECTILE, WEAPON };
+
+struct Collider
+{
+	AABB box;
+	int id;
+	ColliderLayer layer;
+};
+
+//Grid cell covered by a collider
+struct CellRef
+{
+	int cx, cy;
+	int index;
+};
+
+//Uniform grid hashed into a fixed number of buckets. Colliders are registered every frame,
+//sorted once by bucket and then queried. Memory is kept between frames so a steady-state
+//frame doesn't allocate.
+class SpatialHash
+{
+public:
+	SpatialHash();
+	~SpatialHash();
+
+	//Remove every collider, the allocated memory is kept for the next frame
+	void Clear();
+
+	//Register a collider, 'id' is defined by the owner (usually the index in its container)
+	void Insert(int id, const AABB& box, ColliderLayer layer);
+
+	//Sort the registered colliders by bucket, must be called before querying
+	void Build();
+
+	//Append to 'result' the ids of the colliders of 'layer' overlapping 'box'
+	void Query(const AABB& box, ColliderLayer layer, std::vector<int>& result);
+
+	//Append every overlapping pair (id in layer a, id in layer b)
+	//When both layers are the same each pair is reported once
+	void QueryPairs(ColliderLayer a, ColliderLayer b, std::vector<std::pair<int, int>>& result);
+
+	int GetCount() const;
+
+	//Narrowphase tests done by the queries since the last Clear()
+	int GetCandidateCount() const;
+
+private:
+	void CellRange(const AABB& box, int& x0, int& y0, int& x1, int& y1) const;
+	int Bucket(int cx, int cy) const;
+	void QueryIndices(const AABB& box, ColliderLayer layer, std::vector<int>& result);
+
+	std::vector<Collider> colliders;
+	AABBBatch boxes;
+	std::vector<unsigned int> hits;
+
+	//Cells covered by the colliders registered since the last Clear() and their bucket
+	std::vector<CellRef> cells;
+	std::vector<int> cell_bucket;
+	int bucket_count;
+
+	//Collider indices sorted by bucket, bucket b spans [bucket_start[b], bucket_start[b+1])
+	std::vector<int> sorted;
+	std::vector<int> bucket_start;
+
+	//Last query that visited each collider, removes duplicates of colliders spanning several cells
+	std::vector<unsigned int> stamps;
+	unsigned int stamp;
+
+	std::vector<int> scratch;
+	int candidates;
+};
@@ -1,4 +1,7 @@
 #include "Sprite.h"
+#include "RenderQueue.h"
+#include "Snapshot.h"
+#include "MemTracker.h"
 
 Sprite::Sprite(const Texture2D *texture)
 {
@@ -14,6 +17,7 @@ Sprite::~Sprite()
 }
 void Sprite::SetNumberAnimations(int num)
 {
+    MemScope scope(MemTag::SPRITES);
     animations.clear();
     animations.resize(num);
 }
@@ -28,6 +32,7 @@ void Sprite::AddKeyFrame(int id, const Rectangle& rect)
 {
     if (id >= 0 && id < animations.size())
     {
+        MemScope scope(MemTag::SPRITES);
         animations[id].frames.push_back(rect);
     }
 }
@@ -107,7 +112,7 @@ void Sprite::DrawTint(int x, int y, const Color& col) const
     if (current_anim >= 0 && current_anim < animations.size())
     {
         Rectangle rect = animations[current_anim].frames[current_frame];
-        DrawTextureRec(*img, rect, { (float)x, (float)y }, col);
+        RenderQueue::Instance().PushTextureRec(*img, rect, { (float)x, (float)y }, col);
     }
 }
 void Sprite::Release()
@@ -120,3 +125,29 @@ void Sprite::Release()
     //Clear the animations vector
     animations.clear();
 }
+void Sprite::SaveState(BinaryWriter& out) const
+{
+    out.Write(current_anim);
+    out.Write(current_frame);
+    out.Write(current_delay);
+    out.WriteEnum(mode);
+}
+void Sprite::LoadState(BinaryReader& in)
+{
+    in.Read(current_anim);
+    in.Read(current_frame);
+    in.Read(current_delay);
+    in.ReadEnum(mode);
+
+    //Never point outside the frames of the owner
+    if (current_anim < 0 || current_anim >= (int)animations.size() || animations[current_anim].frames.empty())
+    {
+        current_anim = -1;
+        current_frame = 0;
+    }
+    else
+    {
+        current_frame %= (int)animations[current_anim].frames.size();
+        if (current_frame < 0) current_frame = 0;
+    }
+}
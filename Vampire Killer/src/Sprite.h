@@ -3,6 +3,9 @@
 #include "RenderComponent.h"
 #include <vector>
 
+class BinaryWriter;
+class BinaryReader;
+
 enum class AnimMode { AUTOMATIC, MANUAL };
 
 struct Animation
@@ -35,6 +38,10 @@ public:
 
     void Release() override;
 
+    //Animation position, the frames themselves are rebuilt by the owner
+    void SaveState(BinaryWriter& out) const;
+    void LoadState(BinaryReader& in);
+
 private:
     int current_anim;
     int current_frame;
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+
+//Fixed size queue between one producer thread and one consumer thread without locks.
+//The producer only writes 'tail' and the consumer only writes 'head', each one reads the
+//other's index to know how much it can push or pop. Capacity must be a power of two.
+template <typename T, size_t CAPACITY>
+class SpscRing
+{
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+	SpscRing() : head(0), tail(0) {}
+
+	//Producer side, false when the ring is full
+	bool Push(const T& item)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) == CAPACITY) return false;
+
+		items[t & (CAPACITY - 1)] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Consumer side, false when the ring is empty
+	bool Pop(T& item)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return false;
+
+		item = items[h & (CAPACITY - 1)];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Items pushed and items popped since the ring was created, the producer waits for the
+	//consumer by comparing both
+	size_t GetPushed() const { return tail.load(std::memory_order_acquire); }
+	size_t GetPopped() const { return head.load(std::memory_order_acquire); }
+
+private:
+	T items[CAPACITY];
+
+	//Each index in its own cache line so the two threads don't share one
+	alignas(64) std::atomic<size_t> head;
+	alignas(64) std::atomic<size_t> tail;
+};
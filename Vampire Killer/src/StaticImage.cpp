@@ -1,4 +1,5 @@
 #include "StaticImage.h"
+#include "RenderQueue.h"
 
 StaticImage::StaticImage(const Texture2D* texture, const Rectangle& rect)
 {
@@ -14,7 +15,7 @@ void StaticImage::Draw(int x, int y) const
 }
 void StaticImage::DrawTint(int x, int y, const Color& col) const
 {
-	DrawTextureRec(*img, rc, { (float)x, (float)y }, col);
+	RenderQueue::Instance().PushTextureRec(*img, rc, { (float)x, (float)y }, col);
 }
 void StaticImage::Release()
 {
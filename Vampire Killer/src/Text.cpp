@@ -1,4 +1,5 @@
 #include "Text.h"
+#include "RenderQueue.h"
 #include "ResourceManager.h"
 
 Text::Text()
@@ -29,49 +30,72 @@ AppStatus Text::Initialise(Resource id, const std::string& file_path, char first
 	columns = img->width / character_size;
 	rows = img->height / character_size;
 
+	//Rectangle of each character in the texture grid, row by row from first_character
+	glyphs.resize(columns * rows);
+	for (int i = 0; i < columns * rows; ++i)
+	{
+		glyphs[i] = { (float)((i % columns) * character_size), (float)((i / columns) * character_size),
+			(float)character_size, (float)character_size };
+	}
+
 	return AppStatus::OK;
 }
-void Text::Draw(int x, int y, const std::string& text, const Color& col) const
+void Text::Draw(int x, int y, std::string_view text, const Color& col) const
 {
-	//Initialize the horizontal offset to the starting x-coordinate
-	int offset_x = x;
+	RenderQueue& queue = RenderQueue::Instance();
 
-	//Iterate through each character in the text string
-	for (int i = 0; i < text.length(); ++i)
+	//Distance between each character is equal to the character size
+	for (int i = 0; i < (int)text.length(); ++i)
 	{
-		//Draw the current character at the current position with the specified color
-		DrawCharacter(offset_x, y, text[i], col);
-
-		//Update the horizontal offset to position the next character
-		//Distance between each character is equal to the character size
-		offset_x += character_size;
+		const Rectangle* glyph = GetGlyph(text[i]);
+		if (glyph != nullptr) queue.PushTextureRec(*img, *glyph, { (float)(x + i * character_size), (float)y }, col);
 	}
 }
-void Text::DrawCharacter(int x, int y, char c, const Color& col) const
+void Text::Layout(std::string_view text, TextRun& run) const
 {
-	int char_index, coord_x, coord_y, pixel_x, pixel_y;
-
-	//Calculate the character index based on the first character
-	char_index = c - first_character;
-
-	//Calculate the coordinates of the character in the texture grid
-	coord_x = char_index % columns;
-	coord_y = char_index / columns;
-
-	//Check if the calculated coordinates are out of bounds
-	if (coord_x < 0 || coord_x >= columns || coord_y < 0 || coord_y >= rows)
+	run.count = 0;
+	for (int i = 0; i < (int)text.length() && run.count < TEXT_RUN_MAX; ++i)
 	{
-		LOG("Internal error, character index invalid when drawing text: (%d,%d)", coord_x, coord_y);
-		return;
+		const Rectangle* glyph = GetGlyph(text[i]);
+		if (glyph == nullptr) continue;
+		run.glyphs[run.count].src = *glyph;
+		run.glyphs[run.count].x = i * character_size;
+		run.count++;
 	}
+}
+void Text::Draw(int x, int y, const TextRun& run, const Color& col) const
+{
+	RenderQueue& queue = RenderQueue::Instance();
+	for (int i = 0; i < run.count; ++i)
+	{
+		queue.PushTextureRec(*img, run.glyphs[i].src, { (float)(x + run.glyphs[i].x), (float)y }, col);
+	}
+}
+std::string_view Text::FormatNumber(char* buffer, int size, int value, int digits)
+{
+	//Digits are produced from the lowest one, then copied in order
+	char reversed[32];
+	int count = 0;
+	unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+	do
+	{
+		reversed[count++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude > 0);
+	while (count < digits && count < (int)sizeof(reversed)) reversed[count++] = '0';
 
-	//Calculate the pixel coordinates of the character in the texture
-	pixel_x = coord_x * character_size;
-	pixel_y = coord_y * character_size;
-
-	//Define a rectangle representing the character in the texture
-	Rectangle rc = { (float)pixel_x, (float)pixel_y, (float)character_size, (float)character_size };
-
-	//Draw the character
-	DrawTextureRec(*img, rc, { (float)x, (float)y }, col);
-}
\ No newline at end of file
+	int length = 0;
+	if (value < 0 && length < size) buffer[length++] = '-';
+	while (count > 0 && length < size) buffer[length++] = reversed[--count];
+	return std::string_view(buffer, length);
+}
+const Rectangle* Text::GetGlyph(char c) const
+{
+	int char_index = c - first_character;
+	if (char_index < 0 || char_index >= (int)glyphs.size())
+	{
+		LOG("Internal error, character index invalid when drawing text: %d", char_index);
+		return nullptr;
+	}
+	return &glyphs[char_index];
+}
@@ -1,9 +1,26 @@
 #pragma once
 #include "Globals.h"
-#include <string>
+#include <string_view>
+#include <vector>
 #include "raylib.h"
 #include "ResourceManager.h"
 
+//Longest text a TextRun holds, longer texts are cut
+#define TEXT_RUN_MAX	32
+
+//Text laid out once: the rectangle of each character in the font and its horizontal offset.
+//Strings that don't change are laid out at load time and drawn without looking up any glyph.
+struct TextRun
+{
+	struct Glyph
+	{
+		Rectangle src;
+		int x;
+	};
+	int count = 0;
+	Glyph glyphs[TEXT_RUN_MAX];
+};
+
 class Text
 {
 public:
@@ -12,17 +29,32 @@ public:
 	AppStatus Initialise(Resource id, const std::string& file_path, char first_character, int character_size);
 
 	//Method to draw text at a specified position
-	void Draw(int x, int y, const std::string& text, const Color& col = WHITE) const;
+	void Draw(int x, int y, std::string_view text, const Color& col = WHITE) const;
+
+	//Lay out a text once and draw it as many times as needed
+	void Layout(std::string_view text, TextRun& run) const;
+	void Draw(int x, int y, const TextRun& run, const Color& col = WHITE) const;
+
+	//Write 'value' in decimal into 'buffer', padded with zeros up to 'digits' characters.
+	//Unlike TextFormat() there is no allocation and no buffer shared between threads.
+	static std::string_view FormatNumber(char* buffer, int size, int value, int digits);
+	template<int N>
+	static std::string_view FormatNumber(char (&buffer)[N], int value, int digits)
+	{
+		return FormatNumber(buffer, N, value, digits);
+	}
 
 private:
-	// Method to draw a single character at a specified position
-	void DrawCharacter(int x, int y, char c, const Color& col = WHITE) const;
+	//Rectangle of a character in the font texture, nullptr if the font doesn't have it
+	const Rectangle* GetGlyph(char c) const;
 
 	char first_character;	//first character in the bitmap grid
 	int character_size;		//size of each character (constant)
 	int columns;			//number of columns in the bitmap grid
 	int rows;				//number of rows in the bitmap grid
 
+	//Rectangle of every character of the grid, computed once by Initialise()
+	std::vector<Rectangle> glyphs;
+
 	const Texture2D* img;	//reference to the texture containing the characters
 };
-
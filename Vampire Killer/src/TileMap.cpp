@@ -2,6 +2,9 @@
 #include "Globals.h"
 #include "ResourceManager.h"
 #include <cstring>
+#include "Snapshot.h"
+#include "MemTracker.h"
+#include "RenderQueue.h"
 
 TileMap::TileMap()
 {
@@ -42,6 +45,7 @@ TileMap::~TileMap()
 }
 void TileMap::InitTileDictionary()
 {
+	MemScope scope(MemTag::TILEMAP);
 	const int n = TILE_SIZE;
 
 	/* Level Intro */
@@ -243,6 +247,7 @@ AppStatus TileMap::Initialise()
 }
 AppStatus TileMap::Load(int data[], int dataFront[], int dataBack[], int w, int h)
 {
+	MemScope scope(MemTag::TILEMAP);
 	size = w*h;
 	width = w;
 	height = h;
@@ -641,6 +646,7 @@ bool TileMap::CollisionY(const Point& p, int distance) const
 }
 void TileMap::RenderEarly()
 {
+	RenderQueue& queue = RenderQueue::Instance();
 	Tile tile;
 	Rectangle rc;
 	Vector2 pos;
@@ -656,13 +662,14 @@ void TileMap::RenderEarly()
 				pos.y = (float)i * TILE_SIZE;
 
 				rc = dict_rect[(int)tile];
-				DrawTextureRec(*img_tiles, rc, pos, WHITE);
+				queue.PushTextureRec(*img_tiles, rc, pos, WHITE);
 			}
 		}
 	}
 }
 void TileMap::Render()
 {
+	RenderQueue& queue = RenderQueue::Instance();
 	Tile tile;
 	Rectangle rc;
 	Vector2 pos;
@@ -680,12 +687,12 @@ void TileMap::Render()
 				if (tile == Tile::FIRE){
 					fire->Draw((int)pos.x, (int)pos.y);
 				}
-				if (tile == Tile::CANDLE){
+				else if (tile == Tile::CANDLE){
 					candle->Draw((int)pos.x, (int)pos.y);
 				}
 				else {
 					rc = dict_rect[(int)tile];
-					DrawTextureRec(*img_tiles, rc, pos, WHITE);
+					queue.PushTextureRec(*img_tiles, rc, pos, WHITE);
 				}
 				
 			}
@@ -694,6 +701,7 @@ void TileMap::Render()
 }
 void TileMap::RenderLate()
 {
+	RenderQueue& queue = RenderQueue::Instance();
 	Tile tile;
 	Rectangle rc;
 	Vector2 pos;
@@ -709,7 +717,7 @@ void TileMap::RenderLate()
 				pos.y = (float)i * TILE_SIZE;
 
 				rc = dict_rect[(int)tile];
-				DrawTextureRec(*img_tiles, rc, pos, WHITE);
+				queue.PushTextureRec(*img_tiles, rc, pos, WHITE);
 			}
 		}
 	}
@@ -723,4 +731,46 @@ void TileMap::Release()
 	candle->Release();
 
 	dict_rect.clear();
+}
+void TileMap::SaveState(BinaryWriter& out) const
+{
+	out.Write(width);
+	out.Write(height);
+
+	//Tile ids fit in 16 bits
+	const Tile* layers[] = { mapBack, map, mapFront };
+	for (const Tile* layer : layers)
+	{
+		for (int i = 0; i < size; ++i)
+		{
+			out.Write((short)layer[i]);
+		}
+	}
+	fire->SaveState(out);
+	candle->SaveState(out);
+}
+AppStatus TileMap::LoadState(BinaryReader& in)
+{
+	int w = 0, h = 0;
+	in.Read(w);
+	in.Read(h);
+	if (w != width || h != height)
+	{
+		LOG("Snapshot room is %dx%d, loaded room is %dx%d", w, h, width, height);
+		return AppStatus::ERROR;
+	}
+
+	Tile* layers[] = { mapBack, map, mapFront };
+	for (Tile* layer : layers)
+	{
+		for (int i = 0; i < size; ++i)
+		{
+			short tile = 0;
+			in.Read(tile);
+			layer[i] = (Tile)tile;
+		}
+	}
+	fire->LoadState(in);
+	candle->LoadState(in);
+	return AppStatus::OK;
 }
\ No newline at end of file
@@ -145,6 +145,11 @@ public:
 	void RenderLate();
 	void Release();
 
+	//Snapshot of the loaded room including the tiles edited while playing (broken walls,
+	//candles), the room must have been loaded with the same dimensions before restoring
+	void SaveState(BinaryWriter& out) const;
+	AppStatus LoadState(BinaryReader& in);
+
 	//Test for collisions with walls
 	bool TestCollisionWallLeft(const AABB& box) const;
 	bool TestCollisionWallRight(const AABB& box) const;
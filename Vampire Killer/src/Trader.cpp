@@ -1,7 +1,9 @@
 #include "Trader.h"
+#include "World.h"
+#include "Snapshot.h"
 
 
-Trader::Trader(Point pos) : Enemy(pos, TRADER_HITBOX_HEIGHT, TRADER_HITBOX_WIDTH, TRADER_SPRITE_HEIGHT, TRADER_SPRITE_WIDTH)
+Trader::Trader(Point pos, World* world) : Enemy(pos, TRADER_HITBOX_HEIGHT, TRADER_HITBOX_WIDTH, TRADER_SPRITE_HEIGHT, TRADER_SPRITE_WIDTH, world)
 {
 	int AnimationFrame = 0;
 	type = EnemyType::TRADER;
@@ -86,31 +88,32 @@ void Trader::Reset()
 }
 void Trader::Brain()
 {
-	if (EnemyManager::Instance().target->weapon->GetFrame() == 2) {
-		if (currentAnimation == EnemyAnim::RED_TRADER && this->GetHitbox().TestAABB(EnemyManager::Instance().target->weapon->HitboxOnAttack()))
+	if (!nearTarget) return;
+
+	if (world->enemies.target->weapon->GetFrame() == 2) {
+		if (currentAnimation == EnemyAnim::RED_TRADER && this->GetHitbox().TestAABB(world->enemies.target->weapon->HitboxOnAttack()))
 		{
 			PopUp = false;
 			isActive = false;
 			deletePopUp = true;
 			justHit = true;
-			counter = 60;
+			counter = TRADER_HIT_TIME;
 		}
-		else if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->weapon->HitboxOnAttack()) && PopUp == false)
+		else if (this->GetHitbox().TestAABB(world->enemies.target->weapon->HitboxOnAttack()) && PopUp == false)
 		{
-			AudioPlayer::Instance().PlaySoundByName("Attack");
+			Emit(EventType::ENEMY_HIT, 0);
 			PopUp = true;
 			justHit = true;
-			counter = 60;
+			counter = TRADER_HIT_TIME;
 		}
-		else if (this->GetHitbox().TestAABB(EnemyManager::Instance().target->weapon->HitboxOnAttack()) && PopUp == true && EnemyManager::Instance().target->GetHearts() > 50)
+		else if (this->GetHitbox().TestAABB(world->enemies.target->weapon->HitboxOnAttack()) && PopUp == true && world->enemies.target->GetHearts() > 50)
 		{
 			PopUp = false;
 			SetAnimation((int)EnemyAnim::RED_TRADER);
 			currentAnimation = EnemyAnim::RED_TRADER;
-			EnemyManager::Instance().target->DecrHearts(50);
-			EnemyManager::Instance().target->weapon->SetWeapon(WeaponType::CHAIN); // Put Knives when finished
+			EmitItem(EventType::ITEM_PURCHASED, ObjectType::CHAIN, 50); // Put Knives when finished
 			justHit = true;
-			counter = 60;
+			counter = TRADER_HIT_TIME;
 		}
 	}
 }
@@ -128,4 +131,24 @@ void Trader::Release()
 	data.ReleaseTexture(Resource::IMG_TRADER);
 
 	render->Release();
+}
+void Trader::SaveState(BinaryWriter& out) const
+{
+	Enemy::SaveState(out);
+	out.Write(AnimationFrame);
+	out.WriteBool(PopUp);
+	out.WriteBool(justHit);
+	out.WriteBool(deletePopUp);
+	out.Write(counter);
+	out.WriteEnum(currentAnimation);
+}
+void Trader::LoadState(BinaryReader& in)
+{
+	Enemy::LoadState(in);
+	in.Read(AnimationFrame);
+	in.ReadBool(PopUp);
+	in.ReadBool(justHit);
+	in.ReadBool(deletePopUp);
+	in.Read(counter);
+	in.ReadEnum(currentAnimation);
 }
\ No newline at end of file
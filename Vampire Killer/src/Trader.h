@@ -9,11 +9,14 @@
 #define TRADER_HITBOX_HEIGHT	32
 #define TRADER_HITBOX_WIDTH		32
 
+//Time the trader reacts after being hit
+#define TRADER_HIT_TIME			TIME_TO_TICKS(1.0)
+
 
 class Trader : public Enemy
 {
 public:
-	Trader(Point pos);
+	Trader(Point pos, World* world);
 	~Trader();
 
 	AppStatus Initialise();
@@ -34,6 +37,9 @@ public:
 	bool GetPopUp() const override;
 	bool DeletePopUp() const override;
 
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
+
 	int AnimationFrame;
 
 private:
@@ -42,8 +48,8 @@ private:
 	bool justHit = false;
 	bool deletePopUp = false;
 	
-	int counter = 60;
+	int counter = TRADER_HIT_TIME;
 
 	TileMap* map;
-	EnemyAnim currentAnimation;
+	EnemyAnim currentAnimation = EnemyAnim::IDLE_LEFT;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Sprite.h"
 #include "TileMap.h"
 #include "Globals.h"
+#include "Snapshot.h"
 #include <raymath.h>
 
 Weapon::Weapon(const Point& p) :
@@ -10,6 +11,8 @@ Weapon::Weapon(const Point& p) :
 {
 	Initialise();
 	currentWeapon = WeaponType::WHIP;
+	currentLooking = LookAt::RIGHT;
+	currentFrame = -1;
 	SetHitbox({ pos.x + 15, pos.y - 63 }, width, height);
 }
 Weapon::~Weapon()
@@ -144,6 +147,8 @@ AABB Weapon::HitboxOnAttack()
 			}
 		}
 	}
+	//Only the third frame of the attack hits
+	return AABB();
 }
 
 int Weapon::GetFrame() const
@@ -248,4 +253,18 @@ void Weapon::Release()
 	data.ReleaseTexture(Resource::IMG_WEAPON);
 
 	render->Release();
+}
+void Weapon::SaveState(BinaryWriter& out) const
+{
+	Entity::SaveState(out);
+	out.WriteEnum(currentWeapon);
+	out.WriteEnum(currentLooking);
+	out.Write(currentFrame);
+}
+void Weapon::LoadState(BinaryReader& in)
+{
+	Entity::LoadState(in);
+	in.ReadEnum(currentWeapon);
+	in.ReadEnum(currentLooking);
+	in.Read(currentFrame);
 }
\ No newline at end of file
@@ -14,7 +14,7 @@
 #define CHAIN_HEIGHT	8
 
 //Frame delay for updating the attack velocity
-#define PLAYER_ATTACK_DELAY		6
+#define PLAYER_ATTACK_DELAY		TIME_TO_PERIOD(0.1)
 
 //Rendering states
 enum class WeaponAnim {
@@ -54,6 +54,9 @@ public:
 
 	WeaponType GetWeaponType() const;
 
+	void SaveState(BinaryWriter& out) const override;
+	void LoadState(BinaryReader& in) override;
+
 private:
 
 	void AttackRight(int frame);
@@ -0,0 +1,8 @@
+#include "World.h"
+
+World::World(bool audio_enabled, unsigned int seed) : audio(audio_enabled), events(), enemies(this), random(seed)
+{
+}
+World::~World()
+{
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "AudioPlayer.h"
+#include "EventBus.h"
+#include "EnemyManager.h"
+#include "Input.h"
+#include "Random.h"
+
+//State owned by one running game: its audio, its input, its gameplay events, its enemies and
+//its random stream.
+//Textures are shared through ResourceManager, so several worlds can run in the same
+//process, each one with its own Scene.
+class World
+{
+public:
+    //Headless worlds have no audio, used by simulations running without a window
+    World(bool audio_enabled, unsigned int seed = RANDOM_DEFAULT_SEED);
+    ~World();
+
+    //Declared in construction order, the enemy manager loads its sounds through the audio player
+    AudioPlayer audio;
+    EventBus events;
+    EnemyManager enemies;
+    Input input;
+    Random random;
+};
@@ -1,10 +1,72 @@
 #include "Game.h"
-#include "MemLeaks.h"
+#include "MemTracker.h"
 #include "Globals.h"
+#include "BotRunner.h"
+#include "JobSystem.h"
+#include "ResourceManager.h"
+#include "ResourceBudget.h"
+#include <string.h>
+#include <stdlib.h>
 
-int main()
+//Usage: --bots <simulations> [--ticks <ticks>] [--random] [--seed <seed>] [--workers <threads>]
+//              [--record-hashes <file>] [--verify-hashes <file>] [--record-frames <file>] [--verify-frames <file>]
+//Runs the simulations headless across all cores and logs the aggregated stats
+static int RunBots(int argc, char* argv[])
 {
-    ReportMemoryLeaks();
+    BotConfig config;
+    int workers = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc)         config.simulations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)   config.max_ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)    config.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--random") == 0)                  config.policy = BotPolicy::RANDOM_WALK;
+        else if (strcmp(argv[i], "--record-hashes") == 0 && i + 1 < argc)   config.record_hashes = argv[++i];
+        else if (strcmp(argv[i], "--verify-hashes") == 0 && i + 1 < argc)   config.verify_hashes = argv[++i];
+        else if (strcmp(argv[i], "--record-frames") == 0 && i + 1 < argc)   config.record_frames = argv[++i];
+        else if (strcmp(argv[i], "--verify-frames") == 0 && i + 1 < argc)   config.verify_frames = argv[++i];
+    }
+
+    LOG("Bot run start");
+    ResourceManager::Instance().SetHeadless(true);
+    //The software renderer reads the pixels of the textures
+    if (config.record_frames != nullptr || config.verify_frames != nullptr) ResourceManager::Instance().SetKeepImages(true);
+    JobSystem::Instance().Initialise(workers);
+
+    BotStats stats;
+    AppStatus status = BotRunner::Run(config, stats);
+    BotRunner::Report(stats);
+    MemTracker::Report();
+    if (stats.diverged > 0 || stats.frames_diverged > 0) status = AppStatus::ERROR;
+
+    JobSystem::Instance().Shutdown();
+    LOG("Bot run finish");
+    return status == AppStatus::OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//Usage: [--texture-budget <KB>] [--sound-budget <KB>] [--music-budget <KB>]
+//Loading more than the budget writes a warning to the log, there is no budget by default
+static void SetBudgets(int argc, char* argv[])
+{
+    ResourceBudget& budget = ResourceBudget::Instance();
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc)    budget.SetBudget(ResourceKind::TEXTURE, (size_t)atoi(argv[++i]) * 1024);
+        else if (strcmp(argv[i], "--sound-budget") == 0 && i + 1 < argc) budget.SetBudget(ResourceKind::SOUND, (size_t)atoi(argv[++i]) * 1024);
+        else if (strcmp(argv[i], "--music-budget") == 0 && i + 1 < argc) budget.SetBudget(ResourceKind::MUSIC, (size_t)atoi(argv[++i]) * 1024);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    MemTracker::EnableLeakReport();
+    SetBudgets(argc, argv);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--bots") == 0) return RunBots(argc, argv);
+    }
 
     Game *game;
     AppStatus status;
@@ -12,6 +74,10 @@ int main()
 
     LOG("Application start");
     game = new Game();
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--no-idle") == 0) game->SetIdleMode(false);
+    }
     status = game->Initialise(GAME_SCALE_FACTOR);
     if (status != AppStatus::OK)
     {
@@ -33,9 +99,11 @@ int main()
 
     LOG("Application finish");
     game->Cleanup();
- 
-    LOG("Bye :)");
     delete game;
 
+    //Once the game is gone only the memory of the static objects is still live
+    MemTracker::Report();
+    LOG("Bye :)");
+
     return main_return;
 }